@@ -2,9 +2,25 @@
 #include "MPU6050.h"
 #include "DCMotor.h"
 #include "PID.h"
+#include "Encoder.h"
+#include "Ranging.h"
+#include "MAX7219.h"
+#include "DisplayNumber.h"
+#include "Telemetry.h"
+#include "Scheduler.h"
+#include "BootProfile.h"
+#include "BalanceTrim.h"
+#include "ParamStore.h"
 
 
 void Error_Handler(void);
+static void Task_Attitude(void);
+static void Task_Velocity(void);
+static void Task_Telemetry(void);
+static void Task_Ranging(void);
+static void Task_Display(void);
+static void IMU_CalibProgress(uint8_t Captured);
+
 I2C_HandleTypeDef hi2c1;
 MPU6050_Data sensor_data;
 MPU6050_ConvertedData converted_data;
@@ -16,34 +32,204 @@ double Kd = 4.0;
 
 double output = 0;
 
+/*
+ * Balance loop period (attitude task) and D term low pass (~80 Hz). 2 ms, not 1 ms: the
+ * fast-mode read alone takes ~0.45 ms and the double math of the filter and the PID runs
+ * in software, so 1 ms would leave no margin. It has not been measured on the target yet:
+ * check the attitude run time (average in the telemetry, worst case on the display)
+ * before shortening it.
+ */
+#define CONTROL_PERIOD_MS		2
+#define PID_D_FILTER_TAU_S		0.002
+//I term may hold at most half the motor range, the rest stays for P and D
+#define PID_I_LIMIT				(PWM_MAX / 2)
+
+/*
+ * IMU settings: 184 Hz DLPF (1.9 ms gyro delay instead of 4.8 ms at 44 Hz), 1 kHz output
+ * read every second sample by the balance loop (184 Hz stays below the 250 Hz Nyquist
+ * limit), ranges widen during hard recoveries
+ */
+const MPU6050_Config IMU_Config = {
+  .DLPF = MPU6050_DLPF_184HZ,
+  .SampleRateDiv = 0,
+  .GyroRange = MPU6050_GYRO_FS_250DPS,
+  .AccelRange = MPU6050_ACCEL_FS_2G,
+  .AutoRange = ENABLE,
+};
+
+/*
+ * ENABLE to run the six-position accelerometer calibration at boot. The display counts
+ * the faces captured; lay the robot still on each face until the count moves on.
+ * The fit is stored, build again with DISABLE afterwards.
+ */
+#define IMU_ACCEL_CALIBRATION	DISABLE
+
+/*
+ * Task table, fastest first (rate monotonic priority). Odd offsets keep the even period
+ * tasks off the ticks where the attitude task runs.
+ */
+#define TASK_ATTITUDE	0
+#define TASK_VELOCITY	1
+#define TASK_TELEMETRY	2
+#define TASK_RANGING	3
+#define TASK_DISPLAY	4
+
+Scheduler_Task_t Tasks[] = {
+  //Name		Run				Period (ms)					Offset (ms)
+  {"attitude",	Task_Attitude,	CONTROL_PERIOD_MS,			0},		//500 Hz
+  {"velocity",	Task_Velocity,	ENCODER_SAMPLE_PERIOD_MS,	1},		//200 Hz
+  {"telemetry",	Task_Telemetry,	10,							3},		//100 Hz
+  {"ranging",	Task_Ranging,	RANGING_SLOT_MS,			5},		//16.7 Hz
+  {"display",	Task_Display,	MAX7219_ANIM_FRAME_MS,		7},		//20 Hz, one call per keyframe
+};
+
 int main(void){
+  BootProfile_Mark(BOOT_PHASE_MAIN);
+
+  //Priority grouping and SysTick priority before any interrupt is enabled
+  NVIC_Init();
+  //Tick first: the sensor settling and the calibration are timed on it
+  SysTick_Init();
+  BootProfile_Mark(BOOT_PHASE_TICK);
+
+  //Wake the IMU first, the rest of the init overlaps its start-up time
   I2C1_Init(&hi2c1);
-  if (MPU6050_Init(&hi2c1) != I2C_OK){
+  if (MPU6050_InitConfig(&hi2c1, &IMU_Config) != I2C_OK){
 	  Error_Handler();
   }
-  MPU6050_CalibGyro();
-
+  BootProfile_Mark(BOOT_PHASE_IMU_WAKE);
 
   Motor_Init();
+  BootProfile_Mark(BOOT_PHASE_MOTOR);
+  Encoder_Init();
+  BootProfile_Mark(BOOT_PHASE_ENCODER);
 
-  SysTick_Init();
+  //MAX7219 on SPI1, refreshed by DMA. No decode: the animations write segment patterns
+  SPI_Initialize(SPI1, SPI_MODE_MASTER, SPI_POLARITY_LOW, SPI_PHASE_1stEDGE, SPI_MSBFIRST, SPI_DATASIZE_8BIT, SPI_NSS_SOFT);
+  MAX7219_Init(SPI1, MAX7219_NO_DECODE, MAX7219_INTENSITY_7_32, MAX7219_SCAN_DIGIT_0_7);
+  MAX7219_EnableDMA(SPI1);
+  BootProfile_Mark(BOOT_PHASE_DISPLAY);
+
+  Telemetry_Init();
+  BootProfile_Mark(BOOT_PHASE_TELEMETRY);
+
+  Ranging_Init();
+  BootProfile_Mark(BOOT_PHASE_RANGING);
+
+  MPU6050_WaitReady();
+  BootProfile_Mark(BOOT_PHASE_IMU_READY);
+  if(IMU_ACCEL_CALIBRATION == ENABLE){
+      MPU6050_CalibAccel(IMU_CalibProgress);
+  }
+  MPU6050_CalibGyro();
+  BootProfile_Mark(BOOT_PHASE_GYRO_CALIB);
+
+  MPU6050_LearnTempModel();
+  //Room for the records saved while balancing. Motors still off: the rare compaction
+  //(sector erase, 1 to 2 s) may only happen here
+  ParamStore_Reserve(PARAMSTORE_RUNTIME_RESERVE);
+  BootProfile_Mark(BOOT_PHASE_PARAMS);
+
+  BalanceTrim_Init();
 
   PID_Init(&PID, Kp, Ki, Kd);
+  PID_SetDerivativeFilter(&PID, PID_D_FILTER_TAU_S);
+  //Output within the motor range: the int16_t command below cannot wrap
+  PID_SetOutputLimits(&PID, -PWM_MAX, PWM_MAX);
+  PID_SetIntegralLimits(&PID, -PID_I_LIMIT, PID_I_LIMIT);
+
+  //The core sleeps between ticks when no task is due
+  Scheduler_Init(Tasks, sizeof(Tasks) / sizeof(Tasks[0]), NULL);
+  BootProfile_Mark(BOOT_PHASE_BALANCE);
+  Scheduler_Run();
+}
 
-  while(1){
-	  if(MPU6050_ReadData(&hi2c1, &sensor_data) == I2C_OK){
-		  MPU6050_ConvertData(&sensor_data, &converted_data);
-		  MPU6050_Angle = MPU6050_GetAngle(&converted_data);
-	  }
+/**
+  * @brief  Balance loop: tilt estimate, PID and motor command.
+  */
+static void Task_Attitude(void){
+  if(MPU6050_ReadData(&hi2c1, &sensor_data) == I2C_OK){
+	  MPU6050_ConvertData(&sensor_data, &converted_data);
+	  MPU6050_Angle = MPU6050_GetAngle(&converted_data);
+  }
+
+  //D term from the gyro rate. dt is measured: a late release or a slow bus stretches the period
+  output = PID_ComputeRate(&PID, BalanceTrim_Get(), MPU6050_Angle, converted_data.gyro_x_dps, PID_DT_MEASURED);
+
+  Motor_Mix((int16_t)output, 0);
+}
+
+/**
+  * @brief  Wheel speed sampling and balance point estimate.
+  */
+static void Task_Velocity(void){
+  Encoder_Update();
 
-	 output = PID_Compute(&PID, 0, MPU6050_Angle);
+  float speed = 0.5f * (Encoder_GetSpeed(ENCODER_LEFT) + Encoder_GetSpeed(ENCODER_RIGHT));
+  BalanceTrim_Update(MPU6050_Angle, output, speed, ENCODER_SAMPLE_PERIOD_MS / 1000.0f);
+}
 
-	  Motor_Control(MOTOR_LEFT, (int16_t)output);
+/**
+  * @brief  One telemetry frame, dropped by the link if the previous one is still going out.
+  *         The boot profile goes first, before any sample.
+  */
+static void Task_Telemetry(void){
+  static uint8_t bootReported = 0;
+  Telemetry_Sample_t sample;
 
+  if(!bootReported){
+      bootReported = Telemetry_SendBoot();
+      return;
   }
 
+  sample.Tick = getTick();
+  sample.Angle = (int16_t)(MPU6050_Angle * 100.0);
+  sample.Output = (int16_t)output;
+  sample.SpeedLeft = (int16_t)(Encoder_GetSpeed(ENCODER_LEFT) * 100.0f);
+  sample.SpeedRight = (int16_t)(Encoder_GetSpeed(ENCODER_RIGHT) * 100.0f);
+  sample.RangeFront = Ranging_GetDistance(RANGING_SENSOR_FRONT);
+  sample.RangeRear = Ranging_GetDistance(RANGING_SENSOR_REAR);
+  sample.Overruns = (uint16_t)Tasks[TASK_ATTITUDE].Overruns;
+  sample.CpuLoad = Scheduler_GetLoad();
+  sample.ControlExecUs = Tasks[TASK_ATTITUDE].AvgExecUs;
+  sample.Setpoint = (int16_t)(BalanceTrim_Get() * 100.0);
 
+  Telemetry_Send(&sample);
 }
+
+/**
+  * @brief  Ultrasonic sensors, one slot per call.
+  */
+static void Task_Ranging(void){
+  Ranging_Process();
+}
+
+/**
+  * @brief  Tilt in 0.1 deg on the left half, worst balance loop run time in us on the right half.
+  *         A playing animation keeps its digits, the numbers only go to the others.
+  */
+static void Task_Display(void){
+  MAX7219_Anim_Update();
+  uint8_t animDigits = MAX7219_Anim_GetDigitMask();
+
+  if(!(animDigits & 0xF0)){
+      DisplayNumber_Show(MAX7219_REG_DIGIT4, 4, (int32_t)(MPU6050_Angle * 10.0), 1, DISPLAYNUMBER_FLAG_SEGMENTS);
+  }
+  if(!(animDigits & 0x0F)){
+      DisplayNumber_Show(MAX7219_REG_DIGIT0, 4, Tasks[TASK_ATTITUDE].MaxExecUs, 0, DISPLAYNUMBER_FLAG_SEGMENTS);
+  }
+
+  MAX7219_Flush(SPI1);
+}
+
+/**
+  * @brief  Accelerometer calibration progress: faces captured out of 6.
+  */
+static void IMU_CalibProgress(uint8_t Captured){
+  DisplayNumber_Show(MAX7219_REG_DIGIT0, 8, Captured, 0, DISPLAYNUMBER_FLAG_SEGMENTS);
+  MAX7219_Flush(SPI1);
+}
+
 //int main(void){
 //
 //
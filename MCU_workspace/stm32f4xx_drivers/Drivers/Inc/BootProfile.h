@@ -0,0 +1,66 @@
+/*
+ * BootProfile.h
+ *
+ *  Created on: Jul 14, 2025
+ *      Author: quanvm198
+ */
+
+#ifndef INC_BOOTPROFILE_H_
+#define INC_BOOTPROFILE_H_
+
+#include "stm32f407xx.h"
+
+/*
+ * Boot phase time stamps in core cycles from reset (DWT cycle counter, started in
+ * SystemInit before .data/.bss are set up). The table lives in .noinit: it survives a
+ * reset, so after a watchdog or fault reset the phase the previous boot reached can be read.
+ */
+#define BOOTPROFILE_MAGIC			0xB0075EEDU
+#define BOOTPROFILE_CORE_CLOCK_HZ	16000000U	//HSI, no PLL
+
+/*
+ * Phases, in boot order. Each mark is taken at the end of the phase.
+ */
+#define BOOT_PHASE_SYSTEM_INIT		0
+#define BOOT_PHASE_MAIN				1	//Startup copy and C library init done
+#define BOOT_PHASE_TICK				2	//NVIC and SysTick
+#define BOOT_PHASE_IMU_WAKE			3	//I2C, MPU6050 configured and woken up
+#define BOOT_PHASE_MOTOR			4
+#define BOOT_PHASE_ENCODER			5
+#define BOOT_PHASE_DISPLAY			6
+#define BOOT_PHASE_TELEMETRY		7
+#define BOOT_PHASE_RANGING			8
+#define BOOT_PHASE_IMU_READY		9	//Gyro start-up time over
+#define BOOT_PHASE_GYRO_CALIB		10
+#define BOOT_PHASE_PARAMS			11	//Learned parameters saved, store compacted if nearly full
+#define BOOT_PHASE_BALANCE			12	//Scheduler started, balance loop engaged
+#define BOOT_PHASE_COUNT			13
+
+/*
+ * No boot time budget is set yet: the phase times come from the boot report. The init
+ * from MOTOR to RANGING is meant to run inside the 35 ms IMU start-up and the gyro
+ * calibration paces MPU6050_CALIB_SAMPLES reads one per tick. A boot where the parameter
+ * store runs low and compacts (sector erase, 1 to 2 s) shows as a long PARAMS phase.
+ */
+
+#define BOOT_PHASE_NONE				0xFF
+
+/**
+  * @brief  Retained boot table
+  */
+typedef struct
+{
+	uint32_t	Magic;
+	uint32_t	BootCount;					/*!< Boots since power-on					*/
+	uint8_t		LastPhase;					/*!< Last phase reached by this boot		*/
+	uint8_t		PrevLastPhase;				/*!< Last phase reached by the previous boot	*/
+	uint32_t	Cycles[BOOT_PHASE_COUNT];	/*!< Cycles from reset, 0 if not reached	*/
+}BootProfile_t;
+
+
+void BootProfile_Start(void);
+void BootProfile_Mark(uint8_t Phase);
+const BootProfile_t *BootProfile_Get(void);
+uint32_t BootProfile_GetUs(uint8_t Phase);
+
+#endif /* INC_BOOTPROFILE_H_ */
@@ -0,0 +1,61 @@
+/*
+ * ParamStore.h
+ */
+
+#ifndef INC_PARAMSTORE_H_
+#define INC_PARAMSTORE_H_
+
+#include "stm32f407xx.h"
+
+/*
+ * Parameters kept across power cycles in flash sector 11, which the linker scripts keep
+ * out of the image. Records are appended one after the other, the last record of an Id
+ * wins. The sector is only erased when it is full: the live records are copied to RAM,
+ * the sector is erased and they are written back. An erase stalls the CPU for 1 to 2 s,
+ * so writes are meant for boot time, with the motors off.
+ *
+ * While the motors run, ParamStore_Append() adds records without ever erasing; boot code
+ * calls ParamStore_Reserve() so that it finds room.
+ *
+ * Record: header word {Marker, Id, Len, Checksum}, then Len bytes padded to a word.
+ * The header goes first, a record cut by a reset fails its checksum and is skipped.
+ */
+#define PARAMSTORE_SECTOR			FLASH_SECTOR_11
+#define PARAMSTORE_BASEADDR			FLASH_SECTOR_11_BASEADDR
+#define PARAMSTORE_SIZE				FLASH_SECTOR_11_SIZE
+
+#define PARAMSTORE_MARKER			0x5A
+#define PARAMSTORE_MAX_LEN			64		//Payload bytes per record
+#define PARAMSTORE_RUNTIME_RESERVE	4096	//Bytes kept free at boot for ParamStore_Append
+
+/** @defgroup ParamStore_Id Parameter Ids
+  *
+  * One Id per stored structure. The structure layout is part of the record: change
+  * the Id when the layout changes so that an old record is not read back.
+  */
+#define PARAMSTORE_ID_GYRO_TEMP		0		//MPU6050 gyro bias vs temperature model
+#define PARAMSTORE_ID_GYRO_CALIB	1		//MPU6050 gyro bias of the last still boot
+#define PARAMSTORE_ID_ACCEL_CALIB	2		//MPU6050 accelerometer six-position fit
+#define PARAMSTORE_ID_BALANCE_TRIM	3		//Learned balance setpoint
+#define PARAMSTORE_ID_COUNT			8
+
+/** @defgroup ParamStore_Status Parameter store status
+  *
+  */
+typedef enum
+{
+	PARAMSTORE_OK			= 0x00,
+	PARAMSTORE_NOT_FOUND	= 0x01,		/*!< No valid record with this Id and length	*/
+	PARAMSTORE_ERROR		= 0x02,		/*!< Bad argument or flash error				*/
+	PARAMSTORE_FULL			= 0x03		/*!< No room left without an erase				*/
+}ParamStore_StatusTypeDef;
+
+
+void ParamStore_Init(void);
+ParamStore_StatusTypeDef ParamStore_Read(uint8_t Id, void *pData, uint8_t Len);
+ParamStore_StatusTypeDef ParamStore_Write(uint8_t Id, const void *pData, uint8_t Len);
+ParamStore_StatusTypeDef ParamStore_Append(uint8_t Id, const void *pData, uint8_t Len);
+ParamStore_StatusTypeDef ParamStore_Reserve(uint32_t Bytes);
+uint32_t ParamStore_GetFree(void);
+
+#endif /* INC_PARAMSTORE_H_ */
@@ -0,0 +1,59 @@
+/*
+ * Scheduler.h
+ *
+ *  Created on: Jul 13, 2025
+ *      Author: quanvm198
+ */
+
+#ifndef INC_SCHEDULER_H_
+#define INC_SCHEDULER_H_
+
+#include "stm32f407xx.h"
+
+/*
+ * Cooperative multi-rate executive on the 1 ms SysTick.
+ *
+ * Tasks come from a static table sorted by rate (fastest first): the table order is the
+ * priority, and the scan restarts from the top after every task, so a slow task can only
+ * delay a faster one by its own run time. Tasks never block, they run to completion.
+ *
+ * When no task is due the core sleeps (WFI) until the next interrupt, at the latest the
+ * next SysTick. The time spent idle gives the CPU load over SCHEDULER_LOAD_WINDOW_MS.
+ */
+#define SCHEDULER_IDLE_SLEEP		1		//0 keeps the core running when idle (debugging)
+#define SCHEDULER_LOAD_WINDOW_MS	1000
+
+/**
+  * @brief  One periodic task
+  */
+typedef struct
+{
+	const char	*Name;
+	void		(*Run)(void);
+	uint16_t	PeriodMs;			/*!< Release period								*/
+	uint16_t	OffsetMs;			/*!< First release after Scheduler_Init, spreads
+										 tasks of the same rate over different ticks	*/
+
+	/* Runtime statistics, written by the executive */
+	uint32_t	NextRelease;		/*!< getTick() of the next release					*/
+	uint32_t	RunCount;
+	uint32_t	Overruns;			/*!< Releases dropped because the previous one had
+										 not started within a period					*/
+	uint16_t	MaxLatencyMs;		/*!< Worst delay from release to start				*/
+	uint16_t	LastExecUs;			/*!< Run time of the last release					*/
+	uint16_t	MaxExecUs;			/*!< Worst run time									*/
+	uint16_t	AvgExecUs;			/*!< Mean run time over the last load window		*/
+
+	/* Load window accumulators */
+	uint32_t	WindowExecUs;
+	uint32_t	WindowRuns;
+}Scheduler_Task_t;
+
+
+void Scheduler_Init(Scheduler_Task_t *pTasks, uint8_t Count, void (*IdleHook)(void));
+uint8_t Scheduler_RunOnce(void);
+void Scheduler_Run(void);
+void Scheduler_ResetStats(void);
+uint16_t Scheduler_GetLoad(void);
+
+#endif /* INC_SCHEDULER_H_ */
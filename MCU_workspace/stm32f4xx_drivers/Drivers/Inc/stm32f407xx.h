@@ -49,6 +49,32 @@
  */
 #define NVIC_PR_BASEADDR 	((__vo uint32_t*)0xE000E400)
 
+/*
+ * ARM Cortex Mx Processor NVIC ISPRx/ICPRx/IABRx register Addresses
+ */
+#define NVIC_ISPR0			((__vo uint32_t*)0xE000E200)
+#define NVIC_ICPR0			((__vo uint32_t*)0xE000E280)
+#define NVIC_IABR0			((__vo uint32_t*)0xE000E300)
+
+/*
+ * ARM Cortex Mx Processor Priority Register byte access (one byte per IRQ)
+ */
+#define NVIC_IPR_BYTE_BASEADDR	((__vo uint8_t*)0xE000E400)
+
+/*
+ * ARM Cortex Mx Processor System Control Block registers
+ */
+#define SCB_AIRCR			(*(__vo uint32_t*)0xE000ED0C)	// Application interrupt and reset control
+#define SCB_SHPR3			(*(__vo uint32_t*)0xE000ED20)	// System handler priority 3 (PendSV, SysTick)
+
+#define SCB_AIRCR_VECTKEY		(0x05FAUL << 16)	// Write key, required for any AIRCR write
+#define SCB_AIRCR_VECTKEY_MASK	(0xFFFFUL << 16)
+#define SCB_AIRCR_PRIGROUP_Pos	8
+#define SCB_AIRCR_PRIGROUP_MASK	(0x7UL << SCB_AIRCR_PRIGROUP_Pos)
+
+#define SCB_SHPR3_PENDSV_Pos	16
+#define SCB_SHPR3_SYSTICK_Pos	24
+
 /*
  * ARM Cortex Mx Processor number of priority bits implemented in Priority Register
  */
@@ -89,6 +115,13 @@
 #define GPIOI_BASEADDR   (AHB1PERIPH_BASEADDR + 0x2000) /*!< Base address of GPIO Port I */
 
 #define RCC_BASEADDR     (AHB1PERIPH_BASEADDR + 0x3800) /*!< Base address of Reset and Clock Control (RCC) */
+#define FLASH_INTF_BASEADDR (AHB1PERIPH_BASEADDR + 0x3C00) /*!< Base address of the Flash interface registers */
+
+#define DMA1_BASEADDR    (AHB1PERIPH_BASEADDR + 0x6000) /*!< Base address of DMA1 controller */
+#define DMA2_BASEADDR    (AHB1PERIPH_BASEADDR + 0x6400) /*!< Base address of DMA2 controller */
+
+/* Stream x registers start at 0x10 + 0x18 * x from the controller base */
+#define DMA_STREAM_BASEADDR(dmaBase, stream)	((dmaBase) + 0x10 + (0x18 * (stream)))
 
 /*
  * Base addresses of peripherals which are hanging on APB1 bus
@@ -261,6 +294,45 @@ typedef struct
 } USART_RegDef_t;
 
 
+/*
+ * peripheral register definition structure for DMA controller
+ */
+typedef struct
+{
+	__vo uint32_t LISR;       /*!< DMA low interrupt status register,      Address offset: 0x00 */
+	__vo uint32_t HISR;       /*!< DMA high interrupt status register,     Address offset: 0x04 */
+	__vo uint32_t LIFCR;      /*!< DMA low interrupt flag clear register,  Address offset: 0x08 */
+	__vo uint32_t HIFCR;      /*!< DMA high interrupt flag clear register, Address offset: 0x0C */
+} DMA_RegDef_t;
+
+/*
+ * peripheral register definition structure for DMA stream
+ */
+typedef struct
+{
+	__vo uint32_t CR;         /*!< DMA stream x configuration register,      Address offset: 0x00 */
+	__vo uint32_t NDTR;       /*!< DMA stream x number of data register,     Address offset: 0x04 */
+	__vo uint32_t PAR;        /*!< DMA stream x peripheral address register, Address offset: 0x08 */
+	__vo uint32_t M0AR;       /*!< DMA stream x memory 0 address register,   Address offset: 0x0C */
+	__vo uint32_t M1AR;       /*!< DMA stream x memory 1 address register,   Address offset: 0x10 */
+	__vo uint32_t FCR;        /*!< DMA stream x FIFO control register,       Address offset: 0x14 */
+} DMA_Stream_RegDef_t;
+
+
+/*
+ * peripheral register definition structure for Flash interface
+ */
+typedef struct
+{
+	__vo uint32_t ACR;        /*!< Flash access control register,  Address offset: 0x00 */
+	__vo uint32_t KEYR;       /*!< Flash key register,             Address offset: 0x04 */
+	__vo uint32_t OPTKEYR;    /*!< Flash option key register,      Address offset: 0x08 */
+	__vo uint32_t SR;         /*!< Flash status register,          Address offset: 0x0C */
+	__vo uint32_t CR;         /*!< Flash control register,         Address offset: 0x10 */
+	__vo uint32_t OPTCR;      /*!< Flash option control register,  Address offset: 0x14 */
+} FLASH_RegDef_t;
+
+
 /*
  *
  *
@@ -305,6 +377,28 @@ typedef struct
 #define GPIOI  				((GPIO_RegDef_t*)GPIOI_BASEADDR)
 
 #define RCC 				((RCC_RegDef_t*)RCC_BASEADDR)
+
+#define FLASH_INTF			((FLASH_RegDef_t*)FLASH_INTF_BASEADDR)
+
+#define DMA1				((DMA_RegDef_t*)DMA1_BASEADDR)
+#define DMA2				((DMA_RegDef_t*)DMA2_BASEADDR)
+
+#define DMA1_Stream0		((DMA_Stream_RegDef_t*)DMA_STREAM_BASEADDR(DMA1_BASEADDR, 0))
+#define DMA1_Stream1		((DMA_Stream_RegDef_t*)DMA_STREAM_BASEADDR(DMA1_BASEADDR, 1))
+#define DMA1_Stream2		((DMA_Stream_RegDef_t*)DMA_STREAM_BASEADDR(DMA1_BASEADDR, 2))
+#define DMA1_Stream3		((DMA_Stream_RegDef_t*)DMA_STREAM_BASEADDR(DMA1_BASEADDR, 3))
+#define DMA1_Stream4		((DMA_Stream_RegDef_t*)DMA_STREAM_BASEADDR(DMA1_BASEADDR, 4))
+#define DMA1_Stream5		((DMA_Stream_RegDef_t*)DMA_STREAM_BASEADDR(DMA1_BASEADDR, 5))
+#define DMA1_Stream6		((DMA_Stream_RegDef_t*)DMA_STREAM_BASEADDR(DMA1_BASEADDR, 6))
+#define DMA1_Stream7		((DMA_Stream_RegDef_t*)DMA_STREAM_BASEADDR(DMA1_BASEADDR, 7))
+#define DMA2_Stream0		((DMA_Stream_RegDef_t*)DMA_STREAM_BASEADDR(DMA2_BASEADDR, 0))
+#define DMA2_Stream1		((DMA_Stream_RegDef_t*)DMA_STREAM_BASEADDR(DMA2_BASEADDR, 1))
+#define DMA2_Stream2		((DMA_Stream_RegDef_t*)DMA_STREAM_BASEADDR(DMA2_BASEADDR, 2))
+#define DMA2_Stream3		((DMA_Stream_RegDef_t*)DMA_STREAM_BASEADDR(DMA2_BASEADDR, 3))
+#define DMA2_Stream4		((DMA_Stream_RegDef_t*)DMA_STREAM_BASEADDR(DMA2_BASEADDR, 4))
+#define DMA2_Stream5		((DMA_Stream_RegDef_t*)DMA_STREAM_BASEADDR(DMA2_BASEADDR, 5))
+#define DMA2_Stream6		((DMA_Stream_RegDef_t*)DMA_STREAM_BASEADDR(DMA2_BASEADDR, 6))
+#define DMA2_Stream7		((DMA_Stream_RegDef_t*)DMA_STREAM_BASEADDR(DMA2_BASEADDR, 7))
 #define EXTI				((EXTI_RegDef_t*)EXTI_BASEADDR)
 #define SYSCFG				((SYSCFG_RegDef_t*)SYSCFG_BASEADDR)
 
@@ -381,6 +475,12 @@ typedef struct
 #define UART5_CLK_ENABLE()  (RCC->APB1ENR |= (1 << 20))
 #define USART6_CLK_ENABLE() (RCC->APB1ENR |= (1 << 5))
 
+/*
+ * Clock Enable Macros for DMA controllers
+ */
+#define DMA1_CLK_ENABLE()	(RCC->AHB1ENR |= (1 << 21))
+#define DMA2_CLK_ENABLE()	(RCC->AHB1ENR |= (1 << 22))
+
 /*
  * Clock Enable Macros for SYSCFG peripheral
  */
@@ -462,6 +562,9 @@ typedef struct
 
 #define SYSCFG_CLK_DISABLE()  (RCC->APB2ENR &= ~(1 << 14))
 
+#define DMA1_CLK_DISABLE()    (RCC->AHB1ENR &= ~(1 << 21))
+#define DMA2_CLK_DISABLE()    (RCC->AHB1ENR &= ~(1 << 22))
+
 
 /****************** Clock Disable Macros for APB1 TIMx ******************/
 #define TIM2_CLK_DISABLE()        (RCC->APB1ENR &= ~(1 << 0))
@@ -577,6 +680,31 @@ typedef struct
 #define IRQ_NO_UART4	    52
 #define IRQ_NO_UART5	    53
 #define IRQ_NO_USART6	    71
+#define IRQ_NO_TIM1_BRK_TIM9	24
+#define IRQ_NO_TIM1_UP_TIM10	25
+#define IRQ_NO_TIM1_TRG_COM_TIM11	26
+#define IRQ_NO_TIM1_CC		27
+#define IRQ_NO_TIM2			28
+#define IRQ_NO_TIM3			29
+#define IRQ_NO_TIM4			30
+#define IRQ_NO_TIM5			50
+#define IRQ_NO_TIM8_CC		46
+#define IRQ_NO_DMA1_STREAM0	11
+#define IRQ_NO_DMA1_STREAM1	12
+#define IRQ_NO_DMA1_STREAM2	13
+#define IRQ_NO_DMA1_STREAM3	14
+#define IRQ_NO_DMA1_STREAM4	15
+#define IRQ_NO_DMA1_STREAM5	16
+#define IRQ_NO_DMA1_STREAM6	17
+#define IRQ_NO_DMA1_STREAM7	47
+#define IRQ_NO_DMA2_STREAM0	56
+#define IRQ_NO_DMA2_STREAM1	57
+#define IRQ_NO_DMA2_STREAM2	58
+#define IRQ_NO_DMA2_STREAM3	59
+#define IRQ_NO_DMA2_STREAM4	60
+#define IRQ_NO_DMA2_STREAM5	68
+#define IRQ_NO_DMA2_STREAM6	69
+#define IRQ_NO_DMA2_STREAM7	70
 
 
 /*
@@ -776,6 +904,70 @@ typedef struct
 #define USART_SR_LBD        			8
 #define USART_SR_CTS        			9
 
+/*
+ * Bit position definitions DMA_SxCR
+ */
+#define DMA_SxCR_EN						0
+#define DMA_SxCR_DMEIE					1
+#define DMA_SxCR_TEIE					2
+#define DMA_SxCR_HTIE					3
+#define DMA_SxCR_TCIE					4
+#define DMA_SxCR_PFCTRL					5
+#define DMA_SxCR_DIR					6
+#define DMA_SxCR_CIRC					8
+#define DMA_SxCR_PINC					9
+#define DMA_SxCR_MINC					10
+#define DMA_SxCR_PSIZE					11
+#define DMA_SxCR_MSIZE					13
+#define DMA_SxCR_PINCOS					15
+#define DMA_SxCR_PL						16
+#define DMA_SxCR_DBM					18
+#define DMA_SxCR_CT						19
+#define DMA_SxCR_PBURST					21
+#define DMA_SxCR_MBURST					23
+#define DMA_SxCR_CHSEL					25
+
+/*
+ * Bit position definitions DMA_SxFCR
+ */
+#define DMA_SxFCR_FTH					0
+#define DMA_SxFCR_DMDIS					2
+#define DMA_SxFCR_FS					3
+#define DMA_SxFCR_FEIE					7
+
+/*
+ * Bit position definitions of one stream field in DMA_LISR/HISR (and LIFCR/HIFCR)
+ */
+#define DMA_ISR_FEIF					0
+#define DMA_ISR_DMEIF					2
+#define DMA_ISR_TEIF					3
+#define DMA_ISR_HTIF					4
+#define DMA_ISR_TCIF					5
+
+/*
+ * Bit position definitions FLASH_SR
+ */
+#define FLASH_SR_EOP					0
+#define FLASH_SR_OPERR					1
+#define FLASH_SR_WRPERR					4
+#define FLASH_SR_PGAERR					5
+#define FLASH_SR_PGPERR					6
+#define FLASH_SR_PGSERR					7
+#define FLASH_SR_BSY					16
+
+/*
+ * Bit position definitions FLASH_CR
+ */
+#define FLASH_CR_PG						0
+#define FLASH_CR_SER					1
+#define FLASH_CR_MER					2
+#define FLASH_CR_SNB					3
+#define FLASH_CR_PSIZE					8
+#define FLASH_CR_STRT					16
+#define FLASH_CR_EOPIE					24
+#define FLASH_CR_ERRIE					25
+#define FLASH_CR_LOCK					31
+
 #define TIM_CR1_CEN      (1 << 0)   // Counter enable
 #define TIM_CR1_UDIS     (1 << 1)   // Update disable
 #define TIM_CR1_URS      (1 << 2)   // Update request source
@@ -791,14 +983,37 @@ typedef struct
 
 #define TIM_EGR_UG       (1 << 0)   // Update generation (force update)
 
+#define TIM_DIER_UIE     (1 << 0)   // Update interrupt enable
+#define TIM_DIER_CC1IE   (1 << 1)   // Capture/Compare 1 interrupt enable
+#define TIM_DIER_CC2IE   (1 << 2)   // Capture/Compare 2 interrupt enable
+#define TIM_DIER_CC3IE   (1 << 3)   // Capture/Compare 3 interrupt enable
+#define TIM_DIER_CC4IE   (1 << 4)   // Capture/Compare 4 interrupt enable
+
+#define TIM_SR_UIF       (1 << 0)   // Update interrupt flag
+#define TIM_SR_CC1IF     (1 << 1)   // Capture/Compare 1 interrupt flag
+#define TIM_SR_CC2IF     (1 << 2)   // Capture/Compare 2 interrupt flag
+#define TIM_SR_CC3IF     (1 << 3)   // Capture/Compare 3 interrupt flag
+#define TIM_SR_CC4IF     (1 << 4)   // Capture/Compare 4 interrupt flag
+#define TIM_SR_CC1OF     (1 << 9)   // Capture/Compare 1 overcapture flag
+#define TIM_SR_CC2OF     (1 << 10)  // Capture/Compare 2 overcapture flag
+#define TIM_SR_CC3OF     (1 << 11)  // Capture/Compare 3 overcapture flag
+#define TIM_SR_CC4OF     (1 << 12)  // Capture/Compare 4 overcapture flag
+
+#define TIM_BDTR_OSSI    (1 << 10)  // Off-state selection for idle mode (TIM1/TIM8)
+#define TIM_BDTR_OSSR    (1 << 11)  // Off-state selection for run mode (TIM1/TIM8)
+#define TIM_BDTR_MOE     (1 << 15)  // Main output enable (TIM1/TIM8)
+
 #define GPIO_AF4_I2C1 	4
 #define GPIO_AF4_I2C2 	4
+#include "stm32f407xx_nvic.h"
+#include "stm32f407xx_dma.h"
 #include "stm32f407xx_i2c.h"
 #include "stm32f407xx_gpio.h"
 #include "stm32f407xx_spi.h"
 #include "stm32f407xx_usart.h"
 #include "stm32f407xx_rcc.h"
 #include "stm32f407xx_tim.h"
+#include "stm32f407xx_flash.h"
 #include "SysTick.h"
 #include <MPU6050.h>
 #include "SysTick.h"
@@ -0,0 +1,219 @@
+/*
+ * stm32f407xx_dma.h
+ *
+ *  Created on: Jul 8, 2025
+ *      Author: nhduong
+ */
+
+#ifndef INC_STM32F407XX_DMA_H_
+#define INC_STM32F407XX_DMA_H_
+
+#include "stm32f407xx.h"
+
+/**
+  * @brief  DMA Configuration Structure definition
+  */
+typedef struct
+{
+	uint8_t Channel;				/*!< Specifies the request channel of the stream (0..7).
+										 See RM0090 DMA1/DMA2 request mapping tables				*/
+
+	uint8_t Direction;				/*!< Specifies the transfer direction.
+										 This parameter can be a value of @ref DMA_Direction		*/
+
+	uint8_t PeriphInc;				/*!< ENABLE to increment the peripheral address after each item	*/
+
+	uint8_t MemInc;					/*!< ENABLE to increment the memory address after each item		*/
+
+	uint8_t PeriphDataAlignment;	/*!< Peripheral data width.
+										 This parameter can be a value of @ref DMA_Data_Size		*/
+
+	uint8_t MemDataAlignment;		/*!< Memory data width.
+										 This parameter can be a value of @ref DMA_Data_Size		*/
+
+	uint8_t Mode;					/*!< Normal or circular mode.
+										 This parameter can be a value of @ref DMA_Mode				*/
+
+	uint8_t Priority;				/*!< Software priority of the stream.
+										 This parameter can be a value of @ref DMA_Priority			*/
+
+	uint8_t FIFOMode;				/*!< ENABLE to use the FIFO, DISABLE for direct mode			*/
+
+	uint8_t FIFOThreshold;			/*!< FIFO threshold level.
+										 This parameter can be a value of @ref DMA_FIFO_Threshold	*/
+
+	uint8_t MemBurst;				/*!< Memory burst size (FIFO mode only).
+										 This parameter can be a value of @ref DMA_Burst			*/
+
+	uint8_t PeriphBurst;			/*!< Peripheral burst size (FIFO mode only).
+										 This parameter can be a value of @ref DMA_Burst			*/
+
+	uint8_t DoubleBuffer;			/*!< ENABLE for double-buffer mode (DBM), implies circular		*/
+
+}DMA_InitTypeDef;
+
+/**
+  * @brief  DMA handle Structure definition
+  */
+typedef struct DMA_HandleTypeDef
+{
+	DMA_Stream_RegDef_t		*pStream;		/*!< DMA stream registers base address				*/
+
+	DMA_InitTypeDef			Init;			/*!< DMA transfer parameters						*/
+
+	__vo uint8_t			State;			/*!< DMA transfer state @ref DMA_State				*/
+
+	__vo uint32_t			ErrorCode;		/*!< DMA error flags @ref DMA_Error				*/
+
+	void					*Parent;		/*!< Peripheral handle owning this stream			*/
+
+	void (*XferCpltCallback)(struct DMA_HandleTypeDef *hdma);		/*!< Full transfer (memory 0 in DBM) complete	*/
+
+	void (*XferHalfCpltCallback)(struct DMA_HandleTypeDef *hdma);	/*!< Half transfer complete						*/
+
+	void (*XferM1CpltCallback)(struct DMA_HandleTypeDef *hdma);		/*!< Memory 1 transfer complete (DBM only)		*/
+
+	void (*XferErrorCallback)(struct DMA_HandleTypeDef *hdma);		/*!< Transfer error								*/
+
+}DMA_HandleTypeDef;
+
+/** @defgroup DMA_Status DMA status
+  *
+  */
+typedef enum
+{
+	DMA_OK		= 0x00,
+	DMA_ERROR	= 0x01,
+	DMA_BUSY	= 0x02
+}DMA_StatusTypeDef;
+
+/** @defgroup DMA_State DMA State
+  *
+  */
+#define DMA_STATE_RESET				0
+#define DMA_STATE_READY				1
+#define DMA_STATE_BUSY				2
+
+/** @defgroup DMA_Error DMA Error
+  *
+  */
+#define DMA_ERROR_NONE				0x00
+#define DMA_ERROR_TE				0x01	/*!< Transfer error			*/
+#define DMA_ERROR_FE				0x02	/*!< FIFO error				*/
+#define DMA_ERROR_DME				0x04	/*!< Direct mode error		*/
+
+/** @defgroup DMA_Direction DMA Direction
+  *
+  */
+#define DMA_PERIPH_TO_MEMORY		0
+#define DMA_MEMORY_TO_PERIPH		1
+#define DMA_MEMORY_TO_MEMORY		2		/*!< DMA2 only */
+
+/** @defgroup DMA_Data_Size DMA Data Size
+  *
+  */
+#define DMA_DATA_BYTE				0
+#define DMA_DATA_HALFWORD			1
+#define DMA_DATA_WORD				2
+
+/** @defgroup DMA_Mode DMA Mode
+  *
+  */
+#define DMA_NORMAL					0
+#define DMA_CIRCULAR				1
+
+/** @defgroup DMA_Priority DMA Priority
+  *
+  */
+#define DMA_PRIORITY_LOW			0
+#define DMA_PRIORITY_MEDIUM			1
+#define DMA_PRIORITY_HIGH			2
+#define DMA_PRIORITY_VERY_HIGH		3
+
+/** @defgroup DMA_FIFO_Threshold DMA FIFO Threshold
+  *
+  */
+#define DMA_FIFO_THRESHOLD_1QUARTER	0
+#define DMA_FIFO_THRESHOLD_HALF		1
+#define DMA_FIFO_THRESHOLD_3QUARTERS	2
+#define DMA_FIFO_THRESHOLD_FULL		3
+
+/** @defgroup DMA_Burst DMA Burst
+  *
+  */
+#define DMA_BURST_SINGLE			0
+#define DMA_BURST_INC4				1
+#define DMA_BURST_INC8				2
+#define DMA_BURST_INC16				3
+
+/** @defgroup DMA_Memory DMA Memory target (double-buffer mode)
+  *
+  */
+#define DMA_MEMORY_0				0
+#define DMA_MEMORY_1				1
+
+
+/** @defgroup DMA_Allocation DMA stream allocation
+  *
+  * One stream per user, fixed at build time so that two drivers can never claim the same
+  * stream. Stream/channel pairs follow the RM0090 request mapping.
+  *
+  *  Allocation               Request      Stream          Channel
+  *  DMA_ALLOC_IMU_RX         I2C1_RX      DMA1 Stream0    1
+  *  DMA_ALLOC_RANGER_RX      USART2_RX    DMA1 Stream5    4
+  *  DMA_ALLOC_TELEMETRY_TX   USART1_TX    DMA2 Stream7    4
+  *  DMA_ALLOC_DISPLAY_TX     SPI1_TX      DMA2 Stream3    3
+  */
+#define DMA_ALLOC_IMU_RX			0
+#define DMA_ALLOC_RANGER_RX			1
+#define DMA_ALLOC_TELEMETRY_TX		2
+#define DMA_ALLOC_DISPLAY_TX		3
+#define DMA_ALLOC_COUNT				4
+
+
+/*
+ * Number of items left to transfer. In circular mode the write position in the
+ * buffer is (length - DMA_GetCounter()), which makes it the hot path of ring buffers.
+ */
+static inline uint32_t DMA_GetCounter(DMA_HandleTypeDef *hdma)
+{
+	return hdma->pStream->NDTR;
+}
+
+/*
+ * Memory currently used by the stream in double-buffer mode (DMA_MEMORY_0 or DMA_MEMORY_1).
+ */
+static inline uint8_t DMA_GetCurrentMemoryTarget(DMA_HandleTypeDef *hdma)
+{
+	return (hdma->pStream->CR >> DMA_SxCR_CT) & 0x1;
+}
+
+
+/*
+ * Peripheral Clock setup
+ */
+void DMA_PeriClockControl(DMA_RegDef_t *pDMAx, uint8_t clockState);
+
+/*
+ * Init and De-init
+ */
+void DMA_Allocate(DMA_HandleTypeDef *hdma, uint8_t Allocation);
+DMA_StatusTypeDef DMA_Init(DMA_HandleTypeDef *hdma);
+void DMA_DeInit(DMA_HandleTypeDef *hdma);
+
+/*
+ * Transfer control
+ */
+DMA_StatusTypeDef DMA_Start(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint16_t DataLength);
+DMA_StatusTypeDef DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint16_t DataLength);
+DMA_StatusTypeDef DMA_MultiBufferStart_IT(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t SecondMemAddress, uint16_t DataLength);
+DMA_StatusTypeDef DMA_ChangeMemory(DMA_HandleTypeDef *hdma, uint32_t Address, uint8_t Memory);
+DMA_StatusTypeDef DMA_PollForTransfer(DMA_HandleTypeDef *hdma, uint32_t Timeout);
+void DMA_Abort(DMA_HandleTypeDef *hdma);
+
+/*
+ * IRQ handling
+ */
+void DMA_IRQHandling(DMA_HandleTypeDef *hdma);
+
+#endif /* INC_STM32F407XX_DMA_H_ */
@@ -0,0 +1,60 @@
+/*
+ * stm32f407xx_flash.h
+ */
+
+#ifndef INC_STM32F407XX_FLASH_H_
+#define INC_STM32F407XX_FLASH_H_
+
+#include "stm32f407xx.h"
+
+/** @defgroup FLASH_Status FLASH status
+  *
+  */
+typedef enum
+{
+	FLASH_OK		= 0x00,
+	FLASH_ERROR		= 0x01		/*!< Write protection, alignment, parallelism or sequence error */
+}FLASH_StatusTypeDef;
+
+/** @defgroup FLASH_Keys FLASH unlock keys
+  *
+  */
+#define FLASH_KEY1					0x45670123U
+#define FLASH_KEY2					0xCDEF89ABU
+
+/** @defgroup FLASH_Program_Size FLASH program parallelism (PSIZE), needs 2.7 V to 3.6 V for x32
+  *
+  */
+#define FLASH_PSIZE_BYTE			0
+#define FLASH_PSIZE_HALFWORD		1
+#define FLASH_PSIZE_WORD			2
+
+/** @defgroup FLASH_Sector FLASH sectors of the 1 MB device
+  *
+  *  Sector 0..3    16 KB   0x08000000
+  *  Sector 4       64 KB   0x08010000
+  *  Sector 5..11  128 KB   0x08020000
+  */
+#define FLASH_SECTOR_COUNT			12
+#define FLASH_SECTOR_11				11
+#define FLASH_SECTOR_11_BASEADDR	0x080E0000U
+#define FLASH_SECTOR_11_SIZE		0x20000U
+
+#define FLASH_ERASED_WORD			0xFFFFFFFFU
+
+
+/*
+ * Lock control
+ */
+void FLASH_Unlock(void);
+void FLASH_Lock(void);
+
+/*
+ * Erase and program. Flash reads stall while an operation runs: code executing from
+ * flash, interrupts included, is frozen until it completes (up to 2 s for a 128 KB sector).
+ */
+FLASH_StatusTypeDef FLASH_EraseSector(uint8_t Sector);
+FLASH_StatusTypeDef FLASH_ProgramWord(uint32_t Address, uint32_t Data);
+FLASH_StatusTypeDef FLASH_Program(uint32_t Address, const uint32_t *pData, uint32_t WordCount);
+
+#endif /* INC_STM32F407XX_FLASH_H_ */
@@ -119,6 +119,25 @@ typedef struct
 #define		AF15				15
 
 
+/* Fast IO operations, inlined for hot paths ***********************************
+ * All of them are single BSRR stores: atomic with respect to interrupts.
+ */
+static inline void GPIO_SetPinFast(GPIO_RegDef_t *pGPIOx, uint8_t GPIO_pin)
+{
+	pGPIOx->BSRR = (1U << GPIO_pin);
+}
+
+static inline void GPIO_ResetPinFast(GPIO_RegDef_t *pGPIOx, uint8_t GPIO_pin)
+{
+	pGPIOx->BSRR = (1U << (GPIO_pin + 16));
+}
+
+static inline void GPIO_WritePinsFast(GPIO_RegDef_t *pGPIOx, uint16_t SetMask, uint16_t ResetMask)
+{
+	pGPIOx->BSRR = ((uint32_t)ResetMask << 16) | SetMask;
+}
+
+
 /* Peripheral Clock setup function *****************************/
 void GPIO_PeriClockControl(GPIO_RegDef_t *pGPIOx, uint8_t clockState);
 
@@ -131,6 +150,7 @@ uint8_t GPIO_ReadPin(GPIO_RegDef_t *pGPIOx, uint8_t GPIO_pin);
 uint16_t GPIO_ReadPort(GPIO_RegDef_t *pGPIOx);
 void GPIO_WritePin(GPIO_RegDef_t *pGPIOx, uint8_t GPIO_pin, uint8_t pinState);
 void GPIO_WritePort(GPIO_RegDef_t *pGPIOx, uint16_t GPIO_pin);
+void GPIO_WritePins(GPIO_RegDef_t *pGPIOx, uint16_t SetMask, uint16_t ResetMask);
 void GPIO_TogglePin(GPIO_RegDef_t* pGPIOx, uint8_t GPIO_pin);
 void GPIO_Initialize(GPIO_RegDef_t *GPIOx, uint8_t GPIO_Pin, uint8_t GPIO_Mode);
 void GPIO_IRQInterruptConfig(uint8_t IRQNumber, uint8_t state);
@@ -0,0 +1,57 @@
+/*
+ * stm32f407xx_nvic.h
+ *
+ *  Created on: Jul 6, 2025
+ *      Author: nhduong
+ */
+
+#ifndef INC_STM32F407XX_NVIC_H_
+#define INC_STM32F407XX_NVIC_H_
+
+#include "stm32f407xx.h"
+
+
+/** @defgroup NVIC_Priority_Group NVIC Priority Group (value of AIRCR PRIGROUP)
+  *
+  */
+#define NVIC_PRIORITYGROUP_0		0x7U	/*!< 0 bits preemption, 4 bits subpriority */
+#define NVIC_PRIORITYGROUP_1		0x6U	/*!< 1 bit  preemption, 3 bits subpriority */
+#define NVIC_PRIORITYGROUP_2		0x5U	/*!< 2 bits preemption, 2 bits subpriority */
+#define NVIC_PRIORITYGROUP_3		0x4U	/*!< 3 bits preemption, 1 bit  subpriority */
+#define NVIC_PRIORITYGROUP_4		0x3U	/*!< 4 bits preemption, 0 bits subpriority */
+
+
+/** @defgroup IRQ_Priority_Plan Interrupt priority plan
+  *
+  * NVIC_PRIORITYGROUP_4 is used, so every level below preempts all the levels after it
+  * (lower value = more urgent). The control path sits at the top: the 1 ms tick that paces
+  * the control loop and the DMA completions that feed it can never be delayed by
+  * ranging, telemetry or display work.
+  */
+#define IRQ_PRIO_CONTROL_TICK		0	/*!< SysTick, paces the control loop				*/
+#define IRQ_PRIO_DMA				1	/*!< DMA transfer complete/error					*/
+#define IRQ_PRIO_ENCODER			2	/*!< Wheel encoder capture						*/
+#define IRQ_PRIO_SENSOR_BUS			3	/*!< IMU bus (I2C events/errors)					*/
+#define IRQ_PRIO_RANGING			5	/*!< Ultrasonic sensors (USART RX, echo capture)	*/
+#define IRQ_PRIO_TELEMETRY			6	/*!< Telemetry USART TX							*/
+#define IRQ_PRIO_DISPLAY			7	/*!< MAX7219 display SPI						*/
+#define IRQ_PRIO_LOWEST				15
+
+
+/*
+ * APIs supported by this driver
+ */
+void NVIC_IRQInterruptConfig(uint8_t IRQNumber, uint8_t state);
+void NVIC_IRQPriorityConfig(uint8_t IRQNumber, uint8_t IRQPriority);
+uint8_t NVIC_GetPriority(uint8_t IRQNumber);
+void NVIC_SetPendingIRQ(uint8_t IRQNumber);
+void NVIC_ClearPendingIRQ(uint8_t IRQNumber);
+uint8_t NVIC_GetPendingIRQ(uint8_t IRQNumber);
+uint8_t NVIC_GetActive(uint8_t IRQNumber);
+void NVIC_SetPriorityGrouping(uint32_t PriorityGroup);
+uint32_t NVIC_GetPriorityGrouping(void);
+uint8_t NVIC_EncodePriority(uint32_t PriorityGroup, uint8_t PreemptPriority, uint8_t SubPriority);
+void NVIC_SysTickPriorityConfig(uint8_t Priority);
+void NVIC_Init(void);
+
+#endif /* INC_STM32F407XX_NVIC_H_ */
@@ -45,7 +45,7 @@ typedef struct
 /**
   * @brief  SPI handle Structure definition
   */
-typedef struct
+typedef struct SPI_HandleTypeDef
 {
 	SPI_RegDef_t 		*pSPIx;			/*!< SPI registers base address			*/
 
@@ -62,6 +62,16 @@ typedef struct
 	uint8_t				TxState;		/*!< SPI Tx State						*/
 
 	uint8_t 			RxState;		/*!< SPI Rx State						*/
+
+	DMA_HandleTypeDef	*hdmatx;		/*!< SPI Tx DMA handle, NULL if DMA is not used	*/
+
+	void (*TxCpltCallback)(struct SPI_HandleTypeDef *hspi);	/*!< DMA transmit complete, the last frame
+																 has left the shift register. When NULL
+																 SPI_ApplicationEventCallback is called	*/
+
+	void (*TxErrorCallback)(struct SPI_HandleTypeDef *hspi);	/*!< DMA transmit error, the transfer is
+																 over. When NULL SPI_ApplicationEventCallback
+																 is called								*/
 }SPI_HandleTypeDef;
 
 /** @defgroup SPI_Mode SPI Mode
@@ -119,6 +129,7 @@ typedef struct
 #define SPI_STATE_READY       				0
 #define SPI_STATE_BUSY_TX 					1
 #define SPI_STATE_BUSY_RX 					2
+#define SPI_STATE_ERROR						3	/*!< Returned by SPI_Transmit_DMA when the stream cannot start */
 
 
 /** @defgroup SPI_Event SPI Event Definition
@@ -128,6 +139,7 @@ typedef struct
 #define SPI_EVENT_RX_COMPLETE   			2
 #define SPI_EVENT_OVR_ERROR     			3
 #define SPI_EVENT_CRC_ERROR     			4
+#define SPI_EVENT_DMA_ERROR     			5
 
 
 /** @defgroup SPI_Flags_definition SPI Flags Definition
@@ -180,6 +192,7 @@ void SPI_Receive1(SPI_RegDef_t *pSPIx, uint8_t *pRxBuffer, uint32_t Len);
 void SPI_TransmitReceive(SPI_RegDef_t *pSPIx, uint8_t *pTxBuffer, uint8_t *pRxBuffer, uint32_t Len);
 uint8_t SPI_Transmit_IT(SPI_HandleTypeDef *hspi,uint8_t *pTxBuffer, uint32_t Len);
 uint8_t SPI_Receive_IT(SPI_HandleTypeDef *hspi, uint8_t *pRxBuffer, uint32_t Len);
+uint8_t SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, const uint8_t *pTxBuffer, uint16_t Len);
 void SPI_Initialize(SPI_RegDef_t *SPIx, uint8_t SPI_Mode,_Bool SPI_ClockPolarity, _Bool SPI_ClockPhase, _Bool FrameFormat,
 		    _Bool DataFrame_Length, _Bool NSS_SoftwareEnabled);
 
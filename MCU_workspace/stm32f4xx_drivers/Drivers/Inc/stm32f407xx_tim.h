@@ -46,6 +46,13 @@
 #define TIM_ENCODERINPUTPOLARITY_RISING    0  /*!< Rising edge polarity */
 #define TIM_ENCODERINPUTPOLARITY_FALLING   1  /*!< Falling edge polarity */
 
+/*
+ * TIM Input Capture Polarity
+ */
+#define TIM_ICPOLARITY_RISING              0  /*!< Capture on rising edge */
+#define TIM_ICPOLARITY_FALLING             1  /*!< Capture on falling edge */
+#define TIM_ICPOLARITY_BOTHEDGE            2  /*!< Capture on both edges */
+
 /*
  * TIM Channels
  */
@@ -79,6 +86,12 @@
 #define TIM_CCMR3_OC1M_Pos     	4U
 #define TIM_CCMR4_OC1M_Pos     	12U
 
+// Output compare preload enable bits (OCxPE)
+#define TIM_CCMR1_OC1PE_Pos    	3U
+#define TIM_CCMR1_OC2PE_Pos    	11U
+#define TIM_CCMR2_OC3PE_Pos    	3U
+#define TIM_CCMR2_OC4PE_Pos    	11U
+
 
 #define TIM_SMCR_SMS_Pos      0U
 
@@ -99,24 +112,87 @@
 
 #define TIM_CCMR_CCxS_MASK  0x3U  // Mask for 2-bit CCxS field
 
+#define TIM_ARR_MAX_16BIT   0xFFFFU // Largest auto-reload value usable on every timer
+
+
+#define TIM_SMCR_SMS_MASK   0x7U  // Mask for 3-bit SMS field
+
+#define TIM_CCER_CCxNP_Pos  3U    // CCxNP offset within a 4-bit channel field of CCER
+
+#define TIM_PIN_NONE        0xFFU // Channel not routed to a pin
+
+
+/**
+  * @brief  TIM Time Base Configuration Structure definition
+  */
+typedef struct
+{
+	uint32_t Prescaler;			/*!< Specifies the prescaler value used to divide the TIM clock.
+									 This parameter can be a number between 0x0000 and 0xFFFF		*/
+
+	uint32_t Period;			/*!< Specifies the auto-reload value loaded into ARR.
+									 This parameter can be a number between 0x0000 and 0xFFFF		*/
+
+	uint8_t CounterMode;		/*!< Specifies the counter mode.
+									 This parameter can be a value of @ref TIM Counter Mode			*/
+
+}TIM_InitTypeDef;
+
+/**
+  * @brief  TIM handle Structure definition
+  */
+typedef struct
+{
+	TIM_RegDef_t 		*pTIMx;		/*!< TIM registers base address			*/
+
+	TIM_InitTypeDef 	Init;		/*!< TIM time base parameters			*/
+
+}TIM_HandleTypeDef;
+
+
+/*
+ * Hot-path accessors, inlined so the control loop does not pay for a call and a channel switch.
+ * CCR1..CCR4 are contiguous, so TIM_CHANNEL_1..TIM_CHANNEL_4 (0..3) index them directly.
+ */
+static inline void TIM_SetCompare(TIM_HandleTypeDef *htim, uint8_t Channel, uint32_t Value)
+{
+	(&htim->pTIMx->CCR1)[Channel] = Value;
+}
+
+static inline uint32_t TIM_GetCompare(TIM_HandleTypeDef *htim, uint8_t Channel)
+{
+	return (&htim->pTIMx->CCR1)[Channel];
+}
+
+static inline uint32_t TIM_GetCounter(TIM_HandleTypeDef *htim)
+{
+	return htim->pTIMx->CNT;
+}
+
 
-uint16_t TIM_GetCounter(void);
 void TIM_Base_SetConfig(TIM_RegDef_t *pTIMx, uint32_t Prescaler, uint32_t Period, uint32_t DutyCycle);
 void TIM_PeriClockControl(TIM_RegDef_t *pTIMx, uint8_t clockState);
-void GPIO_Init_TIM(uint8_t channel);
+void GPIO_Init_TIM(TIM_RegDef_t *TIMx, uint8_t channel);
 void TIM_SetChannelPolarity(TIM_RegDef_t *TIMx, uint8_t channel, uint8_t polarity);
 void TIM_ChannelOutputControl(TIM_RegDef_t *TIMx, uint8_t channel, uint8_t State);
 void TIM_ConfigTimeBase(TIM_RegDef_t *TIMx, uint32_t Prescaler, uint32_t Period, uint32_t DutyCycle, uint8_t Channel);
 void TIM_SetOCMode(TIM_RegDef_t *TIMx, uint8_t channel, uint8_t OCmode);
-void GPIO_Init_Encoder(void);
+void TIM_SetICMode(TIM_RegDef_t *TIMx, uint8_t channel, uint8_t ICMode);
+void TIM_SetEncoderMode(TIM_RegDef_t *pTIMx, uint8_t EncoderMode);
+void GPIO_Init_Encoder(TIM_RegDef_t *TIMx);
 void TIM_SetConfigEncoder(TIM_RegDef_t *pTIMx, uint8_t CounterMode, uint8_t polarity, uint32_t Prescaler, uint32_t Period, uint8_t EncoderMode);
-void TIM_Encoder_Init(TIM_RegDef_t *TIMx);
+void TIM_Encoder_Init(TIM_HandleTypeDef *htim);
+void TIM_IC_Init(TIM_HandleTypeDef *htim, uint8_t channel, uint8_t polarity);
+void TIM_OC_Init(TIM_HandleTypeDef *htim, uint8_t channel, uint8_t OCMode, uint32_t Pulse);
+void TIM_ITConfig(TIM_RegDef_t *TIMx, uint32_t ITMask, uint8_t State);
+void TIM_IRQInterruptConfig(uint8_t IRQNumber, uint8_t state);
+void TIM_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority);
 
 
 /*
  * Funtions that allow users to init and configure PWM
  */
-void TIM_PWM_Init(TIM_RegDef_t *TIMx,uint8_t channel);
+void TIM_PWM_Init(TIM_HandleTypeDef *htim, uint8_t channel);
 void TIM_SetConfigPWM(TIM_RegDef_t *pTIMx,
                    uint8_t CounterMode,
                    uint8_t Channel,
@@ -125,7 +201,10 @@ void TIM_SetConfigPWM(TIM_RegDef_t *pTIMx,
                    uint32_t Period,
                    uint32_t DutyCycle,
                    uint8_t OCMode);
-void TIM_SetDuty(uint32_t DutyCycle);
+uint32_t TIM_PWM_SetFrequency(TIM_HandleTypeDef *htim, uint32_t FrequencyHz);
+uint32_t TIM_GetClockFreq(TIM_RegDef_t *TIMx);
+void TIM_SetDualCompare(TIM_HandleTypeDef *htim, uint8_t ChannelA, uint32_t ValueA, uint8_t ChannelB, uint32_t ValueB);
+void TIM_SetOCPreload(TIM_RegDef_t *TIMx, uint8_t channel, uint8_t State);
 
 
 
@@ -41,7 +41,7 @@ typedef struct
 /**
   * @brief USART Handle Structure definition
   */
-typedef struct
+typedef struct USART_HandleTypeDef
 {
     USART_RegDef_t          *pUSARTx;       /*!< Usart registers base address               */
 
@@ -59,6 +59,15 @@ typedef struct
 
     uint8_t                 RxState;        /*!< Usart Rx Transfer state                    */
 
+    DMA_HandleTypeDef       *hdmatx;        /*!< Usart Tx DMA handle, NULL if DMA is not used */
+
+    DMA_HandleTypeDef       *hdmarx;        /*!< Usart Rx DMA handle, NULL if DMA is not used */
+
+    void (*RxEventCallback)(struct USART_HandleTypeDef *husart, uint16_t Pos);
+                                            /*!< Receive to idle event: IDLE line, half or full
+                                                 buffer. Pos is the DMA write position in the
+                                                 buffer (0..RxLen-1)                            */
+
 }USART_HandleTypeDef;
 
 /** @defgroup USART_Mode USART Mode
@@ -138,6 +147,7 @@ typedef struct
 #define USART_STATE_READY           0
 #define USART_STATE_BUSY_TX         1
 #define USART_STATE_BUSY_RX         2
+#define USART_STATE_BUSY_RX_DMA     3
 
 /** @defgroup USART_Event_Error USART Event and Error
   *
@@ -150,6 +160,7 @@ typedef struct
 #define     USART_ERR_FE            5
 #define     USART_ERR_NE            6
 #define     USART_ERR_ORE           7
+#define     USART_EVENT_DMA_ERROR   8
 
 /******************************************************************************************
  *                              APIs supported by this driver
@@ -176,6 +187,10 @@ void USART_Transmit(USART_HandleTypeDef *husart, uint8_t *pTxBuffer, uint32_t Le
 void  USART_Receive(USART_HandleTypeDef *husart,uint8_t *pRxBuffer, uint32_t Len);
 uint8_t USART_Transmit_IT(USART_HandleTypeDef *husart,uint8_t *pTxBuffer, uint32_t Len);
 uint8_t USART_Receive_IT(USART_HandleTypeDef *husart,uint8_t *pRxBuffer, uint32_t Len);
+uint8_t USART_Transmit_DMA(USART_HandleTypeDef *husart, uint8_t *pTxBuffer, uint16_t Len);
+uint8_t USART_ReceiveToIdle_DMA(USART_HandleTypeDef *husart, uint8_t *pRxBuffer, uint16_t Len);
+void USART_AbortReceive_DMA(USART_HandleTypeDef *husart);
+uint16_t USART_GetRxDMAPosition(USART_HandleTypeDef *husart);
 
 /*
  * IRQ Configuration and ISR handling
@@ -0,0 +1,77 @@
+/*
+ * BootProfile.c
+ *
+ *  Created on: Jul 14, 2025
+ *      Author: quanvm198
+ */
+
+#include "BootProfile.h"
+
+//Not touched by the startup code, keeps its content across resets
+static BootProfile_t BootProfile __attribute__((section(".noinit")));
+
+/**
+  * @brief  Called by the startup code right after reset, before .data and .bss are initialized.
+  */
+void SystemInit(void){
+  BootProfile_Start();
+}
+
+/**
+  * @brief  Starts the cycle counter from 0 and opens a new boot in the table.
+  *         Must not use initialized data: it runs before the startup copy.
+  * @retval None
+  */
+void BootProfile_Start(void){
+  DEMCR |= DEMCR_TRCENA;
+  DWT_CYCCNT = 0;
+  DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+
+  //RAM content is random after power-on
+  if(BootProfile.Magic != BOOTPROFILE_MAGIC){
+      BootProfile.Magic = BOOTPROFILE_MAGIC;
+      BootProfile.BootCount = 0;
+      BootProfile.LastPhase = BOOT_PHASE_NONE;
+  }
+
+  BootProfile.BootCount++;
+  BootProfile.PrevLastPhase = BootProfile.LastPhase;
+  for(uint8_t i = 0; i < BOOT_PHASE_COUNT; i++){
+      BootProfile.Cycles[i] = 0;
+  }
+
+  BootProfile_Mark(BOOT_PHASE_SYSTEM_INIT);
+}
+
+/**
+  * @brief  Records the end of a boot phase.
+  * @param  Phase: BOOT_PHASE_xxx
+  * @retval None
+  */
+void BootProfile_Mark(uint8_t Phase){
+  if(Phase >= BOOT_PHASE_COUNT){
+      return;
+  }
+
+  BootProfile.Cycles[Phase] = DWT_CYCCNT;
+  BootProfile.LastPhase = Phase;
+}
+
+/**
+  * @brief  Returns the boot table.
+  */
+const BootProfile_t *BootProfile_Get(void){
+  return &BootProfile;
+}
+
+/**
+  * @brief  Returns the time of a phase mark.
+  * @param  Phase: BOOT_PHASE_xxx
+  * @retval Microseconds from reset, 0 if the phase was not reached.
+  */
+uint32_t BootProfile_GetUs(uint8_t Phase){
+  if(Phase >= BOOT_PHASE_COUNT){
+      return 0;
+  }
+  return BootProfile.Cycles[Phase] / (BOOTPROFILE_CORE_CLOCK_HZ / 1000000);
+}
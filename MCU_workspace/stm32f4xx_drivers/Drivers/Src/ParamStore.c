@@ -0,0 +1,325 @@
+/*
+ * ParamStore.c
+ */
+
+#include "ParamStore.h"
+#include <string.h>
+
+#define PARAMSTORE_ENDADDR			(PARAMSTORE_BASEADDR + PARAMSTORE_SIZE)
+#define PARAMSTORE_WORDS(len)		(((uint32_t)(len) + 3) / 4)
+
+#define PARAMSTORE_HDR_MARKER(h)	((uint8_t)(h))
+#define PARAMSTORE_HDR_ID(h)		((uint8_t)((h) >> 8))
+#define PARAMSTORE_HDR_LEN(h)		((uint8_t)((h) >> 16))
+#define PARAMSTORE_HDR_CHECKSUM(h)	((uint8_t)((h) >> 24))
+
+static uint32_t ParamStore_Latest[PARAMSTORE_ID_COUNT];	//Address of the last record per Id, 0 if none
+static uint32_t ParamStore_FreeAddr;						//First erased word
+static uint8_t ParamStore_Ready;
+
+static uint8_t ParamStore_Checksum(uint8_t Id, const uint8_t *pData, uint8_t Len);
+static uint8_t ParamStore_IsUnchanged(uint8_t Id, const void *pData, uint8_t Len);
+static ParamStore_StatusTypeDef ParamStore_Program(uint8_t Id, const uint8_t *pData, uint8_t Len);
+static ParamStore_StatusTypeDef ParamStore_Compact(void);
+
+/**
+  * @brief  Scans the sector for the last record of each Id and the end of the log.
+  * @note   Anything that is not a record ends the log: the space after it cannot be
+  *         trusted to be erased, the next write compacts the sector.
+  * @retval None
+  */
+void ParamStore_Init(void)
+{
+	uint32_t addr = PARAMSTORE_BASEADDR;
+
+	memset(ParamStore_Latest, 0, sizeof(ParamStore_Latest));
+
+	while (addr < PARAMSTORE_ENDADDR)
+	{
+		uint32_t header = *(const uint32_t*)(uintptr_t)addr;
+		if (header == FLASH_ERASED_WORD)
+		{
+			break;
+		}
+
+		uint8_t id = PARAMSTORE_HDR_ID(header);
+		uint8_t len = PARAMSTORE_HDR_LEN(header);
+		uint32_t next = addr + 4 + 4 * PARAMSTORE_WORDS(len);
+
+		if (PARAMSTORE_HDR_MARKER(header) != PARAMSTORE_MARKER || len > PARAMSTORE_MAX_LEN || next > PARAMSTORE_ENDADDR)
+		{
+			addr = PARAMSTORE_ENDADDR;
+			break;
+		}
+
+		if (id < PARAMSTORE_ID_COUNT &&
+			PARAMSTORE_HDR_CHECKSUM(header) == ParamStore_Checksum(id, (const uint8_t*)(uintptr_t)(addr + 4), len))
+		{
+			ParamStore_Latest[id] = addr;
+		}
+
+		addr = next;
+	}
+
+	ParamStore_FreeAddr = addr;
+	ParamStore_Ready = 1;
+}
+
+/**
+  * @brief  Reads the last record of an Id.
+  * @param  Id: value of @ref ParamStore_Id
+  * @param  pData: Destination
+  * @param  Len: Expected length, a record of another length is ignored
+  * @retval PARAMSTORE_OK, PARAMSTORE_NOT_FOUND or PARAMSTORE_ERROR
+  */
+ParamStore_StatusTypeDef ParamStore_Read(uint8_t Id, void *pData, uint8_t Len)
+{
+	if (Id >= PARAMSTORE_ID_COUNT)
+	{
+		return PARAMSTORE_ERROR;
+	}
+
+	if (!ParamStore_Ready)
+	{
+		ParamStore_Init();
+	}
+
+	uint32_t addr = ParamStore_Latest[Id];
+	if (addr == 0 || PARAMSTORE_HDR_LEN(*(const uint32_t*)(uintptr_t)addr) != Len)
+	{
+		return PARAMSTORE_NOT_FOUND;
+	}
+
+	memcpy(pData, (const void*)(uintptr_t)(addr + 4), Len);
+	return PARAMSTORE_OK;
+}
+
+/**
+  * @brief  Stores a new value for an Id. Nothing is written when the value is unchanged.
+  * @note   Blocks for 1 to 2 s when the sector has to be compacted.
+  * @param  Id: value of @ref ParamStore_Id
+  * @param  pData: Value
+  * @param  Len: Length in bytes, at most PARAMSTORE_MAX_LEN
+  * @retval PARAMSTORE_OK or PARAMSTORE_ERROR
+  */
+ParamStore_StatusTypeDef ParamStore_Write(uint8_t Id, const void *pData, uint8_t Len)
+{
+	ParamStore_StatusTypeDef status;
+
+	if (Id >= PARAMSTORE_ID_COUNT || Len > PARAMSTORE_MAX_LEN)
+	{
+		return PARAMSTORE_ERROR;
+	}
+
+	if (!ParamStore_Ready)
+	{
+		ParamStore_Init();
+	}
+
+	//Saves flash wear on the boots where nothing was learned
+	if (ParamStore_IsUnchanged(Id, pData, Len))
+	{
+		return PARAMSTORE_OK;
+	}
+
+	FLASH_Unlock();
+
+	if (ParamStore_FreeAddr + 4 + 4 * PARAMSTORE_WORDS(Len) > PARAMSTORE_ENDADDR)
+	{
+		status = ParamStore_Compact();
+		if (status != PARAMSTORE_OK)
+		{
+			FLASH_Lock();
+			return status;
+		}
+	}
+
+	status = ParamStore_Program(Id, (const uint8_t*)pData, Len);
+
+	FLASH_Lock();
+	return status;
+}
+
+/**
+  * @brief  Stores a new value for an Id without erasing, safe while the motors run: the
+  *         CPU only stalls for the few word programs (about 16 us each).
+  * @param  Id: value of @ref ParamStore_Id
+  * @param  pData: Value
+  * @param  Len: Length in bytes, at most PARAMSTORE_MAX_LEN
+  * @retval PARAMSTORE_OK, PARAMSTORE_FULL (nothing written) or PARAMSTORE_ERROR
+  */
+ParamStore_StatusTypeDef ParamStore_Append(uint8_t Id, const void *pData, uint8_t Len)
+{
+	ParamStore_StatusTypeDef status;
+
+	if (Id >= PARAMSTORE_ID_COUNT || Len > PARAMSTORE_MAX_LEN)
+	{
+		return PARAMSTORE_ERROR;
+	}
+
+	if (!ParamStore_Ready)
+	{
+		ParamStore_Init();
+	}
+
+	if (ParamStore_IsUnchanged(Id, pData, Len))
+	{
+		return PARAMSTORE_OK;
+	}
+
+	if (ParamStore_FreeAddr + 4 + 4 * PARAMSTORE_WORDS(Len) > PARAMSTORE_ENDADDR)
+	{
+		return PARAMSTORE_FULL;
+	}
+
+	FLASH_Unlock();
+	status = ParamStore_Program(Id, (const uint8_t*)pData, Len);
+	FLASH_Lock();
+
+	return status;
+}
+
+/**
+  * @brief  Compacts the sector now when less than Bytes are free. Meant for boot, before
+  *         the motors start, so that ParamStore_Append() does not run out of room.
+  * @note   Blocks for 1 to 2 s when it compacts.
+  * @param  Bytes: Space wanted
+  * @retval PARAMSTORE_OK, PARAMSTORE_FULL if the live records leave less room, or PARAMSTORE_ERROR
+  */
+ParamStore_StatusTypeDef ParamStore_Reserve(uint32_t Bytes)
+{
+	ParamStore_StatusTypeDef status;
+
+	if (ParamStore_GetFree() >= Bytes)
+	{
+		return PARAMSTORE_OK;
+	}
+
+	FLASH_Unlock();
+	status = ParamStore_Compact();
+	FLASH_Lock();
+
+	if (status == PARAMSTORE_OK && ParamStore_GetFree() < Bytes)
+	{
+		return PARAMSTORE_FULL;
+	}
+	return status;
+}
+
+/**
+  * @brief  Returns the space left before the next compaction.
+  * @retval Free bytes
+  */
+uint32_t ParamStore_GetFree(void)
+{
+	if (!ParamStore_Ready)
+	{
+		ParamStore_Init();
+	}
+
+	return PARAMSTORE_ENDADDR - ParamStore_FreeAddr;
+}
+
+
+/**
+  * @brief  Checksum over the Id, the length and the payload. Inverted so that an all-zero
+  *         header, a word programmed over by mistake, never checks.
+  */
+static uint8_t ParamStore_Checksum(uint8_t Id, const uint8_t *pData, uint8_t Len)
+{
+	uint8_t sum = Id + Len;
+
+	for (uint8_t i = 0; i < Len; i++)
+	{
+		sum += pData[i];
+	}
+
+	return (uint8_t)~sum;
+}
+
+/**
+  * @brief  Tells whether the last record of an Id already holds this value.
+  */
+static uint8_t ParamStore_IsUnchanged(uint8_t Id, const void *pData, uint8_t Len)
+{
+	uint32_t addr = ParamStore_Latest[Id];
+
+	return addr && PARAMSTORE_HDR_LEN(*(const uint32_t*)(uintptr_t)addr) == Len &&
+		   memcmp((const void*)(uintptr_t)(addr + 4), pData, Len) == 0;
+}
+
+/**
+  * @brief  Writes one record at the end of the log. The flash must be unlocked and the
+  *         space checked by the caller.
+  */
+static ParamStore_StatusTypeDef ParamStore_Program(uint8_t Id, const uint8_t *pData, uint8_t Len)
+{
+	uint32_t addr = ParamStore_FreeAddr;
+	uint32_t words = PARAMSTORE_WORDS(Len);
+	uint32_t header = PARAMSTORE_MARKER | ((uint32_t)Id << 8) | ((uint32_t)Len << 16) |
+					  ((uint32_t)ParamStore_Checksum(Id, pData, Len) << 24);
+
+	//Whatever happens next the words are used, a failed record is skipped by the scan
+	ParamStore_FreeAddr = addr + 4 + 4 * words;
+
+	if (FLASH_ProgramWord(addr, header) != FLASH_OK)
+	{
+		return PARAMSTORE_ERROR;
+	}
+
+	for (uint32_t i = 0; i < words; i++)
+	{
+		//Last word padded with the erased value
+		uint32_t word = FLASH_ERASED_WORD;
+		uint32_t n = (Len - 4 * i < 4) ? (Len - 4 * i) : 4;
+		memcpy(&word, &pData[4 * i], n);
+
+		if (FLASH_ProgramWord(addr + 4 + 4 * i, word) != FLASH_OK)
+		{
+			return PARAMSTORE_ERROR;
+		}
+	}
+
+	ParamStore_Latest[Id] = addr;
+	return PARAMSTORE_OK;
+}
+
+/**
+  * @brief  Keeps only the last record of each Id: copy to RAM, erase, write back.
+  *         A reset in between loses the parameters, they are learned again.
+  */
+static ParamStore_StatusTypeDef ParamStore_Compact(void)
+{
+	static uint8_t copy[PARAMSTORE_ID_COUNT][PARAMSTORE_MAX_LEN];
+	uint8_t len[PARAMSTORE_ID_COUNT];
+	uint8_t live[PARAMSTORE_ID_COUNT];
+
+	for (uint8_t id = 0; id < PARAMSTORE_ID_COUNT; id++)
+	{
+		uint32_t addr = ParamStore_Latest[id];
+		live[id] = (addr != 0);
+		if (live[id])
+		{
+			len[id] = PARAMSTORE_HDR_LEN(*(const uint32_t*)(uintptr_t)addr);
+			memcpy(copy[id], (const void*)(uintptr_t)(addr + 4), len[id]);
+		}
+	}
+
+	if (FLASH_EraseSector(PARAMSTORE_SECTOR) != FLASH_OK)
+	{
+		return PARAMSTORE_ERROR;
+	}
+
+	memset(ParamStore_Latest, 0, sizeof(ParamStore_Latest));
+	ParamStore_FreeAddr = PARAMSTORE_BASEADDR;
+
+	for (uint8_t id = 0; id < PARAMSTORE_ID_COUNT; id++)
+	{
+		if (live[id] && ParamStore_Program(id, copy[id], len[id]) != PARAMSTORE_OK)
+		{
+			return PARAMSTORE_ERROR;
+		}
+	}
+
+	return PARAMSTORE_OK;
+}
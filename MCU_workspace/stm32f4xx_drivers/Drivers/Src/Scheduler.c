@@ -0,0 +1,182 @@
+/*
+ * Scheduler.c
+ *
+ *  Created on: Jul 13, 2025
+ *      Author: quanvm198
+ */
+
+#include "Scheduler.h"
+
+static Scheduler_Task_t *Scheduler_Tasks;
+static uint8_t Scheduler_TaskCount;
+static void (*Scheduler_IdleHook)(void);
+
+//CPU load from the idle time
+static uint32_t Scheduler_WindowStart;
+static uint32_t Scheduler_IdleUs;
+static uint16_t Scheduler_Load;
+
+static void Scheduler_Idle(uint32_t Now);
+static void Scheduler_UpdateLoad(void);
+
+/**
+  * @brief  Registers the task table and sets the first release of every task.
+  *         SysTick must be running.
+  * @param  pTasks: Task table, highest rate first. Only the configuration fields need
+  *         to be set, the statistics are cleared here.
+  * @param  Count: Number of tasks in the table.
+  * @param  IdleHook: Called when no task is ready, NULL if none.
+  * @retval None
+  */
+void Scheduler_Init(Scheduler_Task_t *pTasks, uint8_t Count, void (*IdleHook)(void)){
+  uint32_t now = getTick();
+
+  Scheduler_Tasks = pTasks;
+  Scheduler_TaskCount = Count;
+  Scheduler_IdleHook = IdleHook;
+
+  for(uint8_t i = 0; i < Count; i++){
+      pTasks[i].NextRelease = now + pTasks[i].OffsetMs;
+  }
+  Scheduler_ResetStats();
+
+  Scheduler_WindowStart = getMicros();
+  Scheduler_IdleUs = 0;
+  Scheduler_Load = 0;
+}
+
+/**
+  * @brief  Runs the highest priority task that is due, or idles until the next interrupt.
+  *
+  * A task is released every PeriodMs. When it starts a whole period or more after its
+  * release, the missed releases are dropped and counted as overruns instead of being run
+  * back to back, so the task keeps its phase and never bursts.
+  *
+  * @retval 1 if a task ran, 0 if the scheduler idled.
+  */
+uint8_t Scheduler_RunOnce(void){
+  uint32_t now = getTick();
+
+  for(uint8_t i = 0; i < Scheduler_TaskCount; i++){
+      Scheduler_Task_t *pTask = &Scheduler_Tasks[i];
+
+      if((int32_t)(now - pTask->NextRelease) < 0){
+	  continue;
+      }
+
+      uint32_t latency = now - pTask->NextRelease;
+      if(latency >= pTask->PeriodMs){
+	  uint32_t missed = latency / pTask->PeriodMs;
+	  pTask->Overruns += missed;
+	  pTask->NextRelease += missed * pTask->PeriodMs;
+	  latency -= missed * pTask->PeriodMs;
+      }
+      pTask->NextRelease += pTask->PeriodMs;
+
+      if(latency > pTask->MaxLatencyMs){
+	  pTask->MaxLatencyMs = (uint16_t)latency;
+      }
+      pTask->RunCount++;
+
+      uint32_t start = getMicros();
+      pTask->Run();
+      uint32_t exec = getMicros() - start;
+
+      pTask->LastExecUs = (exec > 0xFFFF) ? 0xFFFF : (uint16_t)exec;
+      if(pTask->LastExecUs > pTask->MaxExecUs){
+	  pTask->MaxExecUs = pTask->LastExecUs;
+      }
+      pTask->WindowExecUs += exec;
+      pTask->WindowRuns++;
+
+      Scheduler_UpdateLoad();
+      return 1;
+  }
+
+  Scheduler_Idle(now);
+  Scheduler_UpdateLoad();
+  return 0;
+}
+
+/**
+  * @brief  Dispatches the task table forever.
+  * @retval None
+  */
+void Scheduler_Run(void){
+  while(1){
+      Scheduler_RunOnce();
+  }
+}
+
+/**
+  * @brief  Clears the run, overrun and latency statistics of all tasks.
+  * @retval None
+  */
+void Scheduler_ResetStats(void){
+  for(uint8_t i = 0; i < Scheduler_TaskCount; i++){
+      Scheduler_Tasks[i].RunCount = 0;
+      Scheduler_Tasks[i].Overruns = 0;
+      Scheduler_Tasks[i].MaxLatencyMs = 0;
+      Scheduler_Tasks[i].MaxExecUs = 0;
+  }
+}
+
+/**
+  * @brief  Returns the CPU load over the last complete load window.
+  * @retval Busy time in 0.1 % (0..1000).
+  */
+uint16_t Scheduler_GetLoad(void){
+  return Scheduler_Load;
+}
+
+
+/**
+  * @brief  Runs the idle hook, then sleeps until the next interrupt unless a tick
+  *         arrived meanwhile. Interrupts are masked around the check so that a tick
+  *         between the check and WFI still wakes the core (a pending interrupt ends
+  *         WFI even with PRIMASK set) and is handled right after.
+  * @param  Now: getTick() used for the last scan of the table.
+  */
+static void Scheduler_Idle(uint32_t Now){
+  uint32_t start = getMicros();
+
+  if(Scheduler_IdleHook != NULL){
+      Scheduler_IdleHook();
+  }
+
+#if SCHEDULER_IDLE_SLEEP
+  __asm volatile ("cpsid i" ::: "memory");
+  if(getTick() == Now){
+      __asm volatile ("dsb\n\twfi" ::: "memory");
+  }
+  __asm volatile ("cpsie i" ::: "memory");
+#endif
+
+  Scheduler_IdleUs += getMicros() - start;
+}
+
+/**
+  * @brief  Closes the load window when it is over: CPU load and mean run time of the tasks.
+  */
+static void Scheduler_UpdateLoad(void){
+  uint32_t elapsed = getMicros() - Scheduler_WindowStart;
+
+  if(elapsed < (uint32_t)SCHEDULER_LOAD_WINDOW_MS * 1000){
+      return;
+  }
+
+  uint32_t idle = (Scheduler_IdleUs > elapsed) ? elapsed : Scheduler_IdleUs;
+  Scheduler_Load = (uint16_t)(1000 - (uint32_t)(((uint64_t)idle * 1000) / elapsed));
+
+  for(uint8_t i = 0; i < Scheduler_TaskCount; i++){
+      Scheduler_Task_t *pTask = &Scheduler_Tasks[i];
+      if(pTask->WindowRuns){
+	  pTask->AvgExecUs = (uint16_t)(pTask->WindowExecUs / pTask->WindowRuns);
+      }
+      pTask->WindowExecUs = 0;
+      pTask->WindowRuns = 0;
+  }
+
+  Scheduler_WindowStart += elapsed;
+  Scheduler_IdleUs = 0;
+}
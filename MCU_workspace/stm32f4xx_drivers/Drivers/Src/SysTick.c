@@ -1,5 +1,5 @@
 #include "SysTick.h"
-uint32_t ticks = 0;
+__vo uint32_t ticks = 0;
 uint32_t ClockFreq = 2000000;
 
 /**
@@ -73,6 +73,26 @@ uint32_t getTick(void){
 	return ticks;
 }
 
+/**
+ * @brief Returns a microsecond time stamp built from the tick count and the SysTick counter.
+ * Resolution is one SysTick clock (0.5 us at 2 MHz), wraps after ~71 minutes.
+ * Call from thread mode or from an interrupt of lower priority than SysTick.
+ * @param None
+ * @retval Current time (in us)
+ */
+uint32_t getMicros(void){
+	uint32_t ms, val;
+	uint32_t load = SYSTICK->STK_LOAD;
+
+	//Retry if the tick interrupt ran between the two reads
+	do{
+		ms = ticks;
+		val = SYSTICK->STK_VAL;
+	}while(ms != ticks);
+
+	return ms * 1000 + ((load - val) * 1000) / (load + 1);
+}
+
 /**
  * @brief SysTick interrupt handler, called every 1 ms.
  * Increments the global tick counter.
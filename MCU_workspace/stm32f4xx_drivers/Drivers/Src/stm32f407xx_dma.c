@@ -0,0 +1,562 @@
+/*
+ * stm32f407xx_dma.c
+ *
+ *  Created on: Jul 8, 2025
+ *      Author: nhduong
+ */
+
+#include "stm32f407xx_dma.h"
+
+/*
+ * Flag bits of one stream inside LISR/HISR
+ */
+#define DMA_STREAM_FLAGS_MASK	((1 << DMA_ISR_FEIF) | (1 << DMA_ISR_DMEIF) | (1 << DMA_ISR_TEIF) | \
+								 (1 << DMA_ISR_HTIF) | (1 << DMA_ISR_TCIF))
+
+#define DMA_STREAM_COUNT		16		/*!< 8 streams on DMA1 then 8 on DMA2 */
+
+/**
+  * @brief  Stream allocation entry
+  */
+typedef struct
+{
+	DMA_Stream_RegDef_t	*pStream;
+	uint8_t				Channel;
+}DMA_Allocation_t;
+
+static const DMA_Allocation_t DMA_AllocationTable[DMA_ALLOC_COUNT] =
+{
+	[DMA_ALLOC_IMU_RX]			= { DMA1_Stream0, 1 },
+	[DMA_ALLOC_RANGER_RX]		= { DMA1_Stream5, 4 },
+	[DMA_ALLOC_TELEMETRY_TX]	= { DMA2_Stream7, 4 },
+	[DMA_ALLOC_DISPLAY_TX]		= { DMA2_Stream3, 3 },
+};
+
+/* Bit offset of the flags of stream 0..3 (and 4..7) in LISR/HISR */
+static const uint8_t DMA_FlagShift[4] = { 0, 6, 16, 22 };
+
+/* NVIC line of each stream, same order as the registry */
+static const uint8_t DMA_StreamIRQ[DMA_STREAM_COUNT] =
+{
+	IRQ_NO_DMA1_STREAM0, IRQ_NO_DMA1_STREAM1, IRQ_NO_DMA1_STREAM2, IRQ_NO_DMA1_STREAM3,
+	IRQ_NO_DMA1_STREAM4, IRQ_NO_DMA1_STREAM5, IRQ_NO_DMA1_STREAM6, IRQ_NO_DMA1_STREAM7,
+	IRQ_NO_DMA2_STREAM0, IRQ_NO_DMA2_STREAM1, IRQ_NO_DMA2_STREAM2, IRQ_NO_DMA2_STREAM3,
+	IRQ_NO_DMA2_STREAM4, IRQ_NO_DMA2_STREAM5, IRQ_NO_DMA2_STREAM6, IRQ_NO_DMA2_STREAM7
+};
+
+/* Handle registered on each stream, used by the stream IRQ handlers */
+static DMA_HandleTypeDef *DMA_Registry[DMA_STREAM_COUNT];
+
+static uint8_t DMA_GetStreamIndex(DMA_Stream_RegDef_t *pStream);
+static DMA_RegDef_t *DMA_GetController(DMA_Stream_RegDef_t *pStream);
+static uint32_t DMA_ReadFlags(DMA_HandleTypeDef *hdma);
+static void DMA_ClearFlags(DMA_HandleTypeDef *hdma, uint32_t Flags);
+static void DMA_DisableStream(DMA_HandleTypeDef *hdma);
+static void DMA_SetConfig(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint16_t DataLength);
+static void DMA_EnableInterrupts(DMA_HandleTypeDef *hdma);
+
+/**
+  * @brief  Enables or disables the clock of a DMA controller.
+  * @param  pDMAx DMA1 or DMA2.
+  * @param  clockState ENABLE or DISABLE.
+  * @retval None
+  */
+void DMA_PeriClockControl(DMA_RegDef_t *pDMAx, uint8_t clockState)
+{
+	if (clockState == ENABLE)
+	{
+		if (pDMAx == DMA1)			DMA1_CLK_ENABLE();
+		else if (pDMAx == DMA2)		DMA2_CLK_ENABLE();
+	}
+	else
+	{
+		if (pDMAx == DMA1)			DMA1_CLK_DISABLE();
+		else if (pDMAx == DMA2)		DMA2_CLK_DISABLE();
+	}
+}
+
+/**
+  * @brief  Fills the stream and request channel of a handle from the allocation table.
+  * @param  hdma Pointer to DMA handle.
+  * @param  Allocation value of @ref DMA_Allocation.
+  * @retval None
+  */
+void DMA_Allocate(DMA_HandleTypeDef *hdma, uint8_t Allocation)
+{
+	if (Allocation < DMA_ALLOC_COUNT)
+	{
+		hdma->pStream = DMA_AllocationTable[Allocation].pStream;
+		hdma->Init.Channel = DMA_AllocationTable[Allocation].Channel;
+	}
+}
+
+/**
+  * @brief  Initializes a DMA stream according to hdma->Init and registers the handle
+  *         for the stream interrupt.
+  * @param  hdma Pointer to DMA handle.
+  * @retval DMA_OK, or DMA_ERROR if the stream is already owned by another handle.
+  */
+DMA_StatusTypeDef DMA_Init(DMA_HandleTypeDef *hdma)
+{
+	uint8_t index = DMA_GetStreamIndex(hdma->pStream);
+	uint32_t temp = 0;
+
+	if (DMA_Registry[index] != NULL && DMA_Registry[index] != hdma)
+	{
+		return DMA_ERROR;
+	}
+
+	DMA_PeriClockControl(DMA_GetController(hdma->pStream), ENABLE);
+
+	DMA_DisableStream(hdma);
+
+	// 1. Configuration register
+	temp |= ((uint32_t)(hdma->Init.Channel & 0x7) << DMA_SxCR_CHSEL);
+	temp |= ((uint32_t)hdma->Init.Direction << DMA_SxCR_DIR);
+	temp |= ((uint32_t)hdma->Init.PeriphDataAlignment << DMA_SxCR_PSIZE);
+	temp |= ((uint32_t)hdma->Init.MemDataAlignment << DMA_SxCR_MSIZE);
+	temp |= ((uint32_t)hdma->Init.Priority << DMA_SxCR_PL);
+
+	if (hdma->Init.PeriphInc == ENABLE)
+		temp |= (1 << DMA_SxCR_PINC);
+	if (hdma->Init.MemInc == ENABLE)
+		temp |= (1 << DMA_SxCR_MINC);
+	if (hdma->Init.Mode == DMA_CIRCULAR || hdma->Init.DoubleBuffer == ENABLE)
+		temp |= (1 << DMA_SxCR_CIRC);
+	if (hdma->Init.DoubleBuffer == ENABLE)
+		temp |= (1 << DMA_SxCR_DBM);
+
+	// Bursts are only allowed with the FIFO enabled
+	if (hdma->Init.FIFOMode == ENABLE)
+	{
+		temp |= ((uint32_t)hdma->Init.MemBurst << DMA_SxCR_MBURST);
+		temp |= ((uint32_t)hdma->Init.PeriphBurst << DMA_SxCR_PBURST);
+	}
+	hdma->pStream->CR = temp;
+
+	// 2. FIFO control register
+	temp = 0;
+	if (hdma->Init.FIFOMode == ENABLE)
+	{
+		temp |= (1 << DMA_SxFCR_DMDIS);
+		temp |= ((uint32_t)hdma->Init.FIFOThreshold << DMA_SxFCR_FTH);
+	}
+	hdma->pStream->FCR = temp;
+
+	DMA_ClearFlags(hdma, DMA_STREAM_FLAGS_MASK);
+
+	// 3. Register the handle and enable the stream interrupt
+	DMA_Registry[index] = hdma;
+	NVIC_IRQPriorityConfig(DMA_StreamIRQ[index], IRQ_PRIO_DMA);
+	NVIC_IRQInterruptConfig(DMA_StreamIRQ[index], ENABLE);
+
+	hdma->ErrorCode = DMA_ERROR_NONE;
+	hdma->State = DMA_STATE_READY;
+
+	return DMA_OK;
+}
+
+/**
+  * @brief  Disables a DMA stream and releases it.
+  * @param  hdma Pointer to DMA handle.
+  * @retval None
+  */
+void DMA_DeInit(DMA_HandleTypeDef *hdma)
+{
+	uint8_t index = DMA_GetStreamIndex(hdma->pStream);
+
+	DMA_DisableStream(hdma);
+	NVIC_IRQInterruptConfig(DMA_StreamIRQ[index], DISABLE);
+
+	hdma->pStream->CR = 0;
+	hdma->pStream->NDTR = 0;
+	hdma->pStream->PAR = 0;
+	hdma->pStream->M0AR = 0;
+	hdma->pStream->M1AR = 0;
+	hdma->pStream->FCR = (1 << 5);	// reset value: FIFO empty status
+	DMA_ClearFlags(hdma, DMA_STREAM_FLAGS_MASK);
+
+	if (DMA_Registry[index] == hdma)
+	{
+		DMA_Registry[index] = NULL;
+	}
+	hdma->State = DMA_STATE_RESET;
+}
+
+/**
+  * @brief  Starts a transfer without interrupts.
+  * @param  hdma Pointer to DMA handle.
+  * @param  SrcAddress Source address (peripheral register for DMA_PERIPH_TO_MEMORY).
+  * @param  DstAddress Destination address (peripheral register for DMA_MEMORY_TO_PERIPH).
+  * @param  DataLength Number of items to transfer (1..65535).
+  * @retval DMA_OK or DMA_BUSY.
+  */
+DMA_StatusTypeDef DMA_Start(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint16_t DataLength)
+{
+	if (hdma->State != DMA_STATE_READY)
+	{
+		return DMA_BUSY;
+	}
+
+	hdma->State = DMA_STATE_BUSY;
+	hdma->ErrorCode = DMA_ERROR_NONE;
+
+	DMA_SetConfig(hdma, SrcAddress, DstAddress, DataLength);
+	hdma->pStream->CR |= (1 << DMA_SxCR_EN);
+
+	return DMA_OK;
+}
+
+/**
+  * @brief  Starts a transfer with transfer complete, error and, if a callback is set,
+  *         half transfer interrupts.
+  * @param  hdma Pointer to DMA handle.
+  * @param  SrcAddress Source address.
+  * @param  DstAddress Destination address.
+  * @param  DataLength Number of items to transfer (1..65535).
+  * @retval DMA_OK or DMA_BUSY.
+  */
+DMA_StatusTypeDef DMA_Start_IT(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint16_t DataLength)
+{
+	if (hdma->State != DMA_STATE_READY)
+	{
+		return DMA_BUSY;
+	}
+
+	hdma->State = DMA_STATE_BUSY;
+	hdma->ErrorCode = DMA_ERROR_NONE;
+
+	DMA_SetConfig(hdma, SrcAddress, DstAddress, DataLength);
+	DMA_EnableInterrupts(hdma);
+	hdma->pStream->CR |= (1 << DMA_SxCR_EN);
+
+	return DMA_OK;
+}
+
+/**
+  * @brief  Starts a double-buffer transfer: the stream alternates between memory 0
+  *         (DstAddress/SrcAddress) and memory 1 (SecondMemAddress) on every completion.
+  *         XferCpltCallback reports memory 0 done, XferM1CpltCallback memory 1 done.
+  * @note   Init.DoubleBuffer must be ENABLE. Not available for memory to memory.
+  * @param  hdma Pointer to DMA handle.
+  * @param  SrcAddress Source address.
+  * @param  DstAddress Destination address.
+  * @param  SecondMemAddress Memory 1 address.
+  * @param  DataLength Number of items per buffer (1..65535).
+  * @retval DMA_OK, DMA_BUSY or DMA_ERROR.
+  */
+DMA_StatusTypeDef DMA_MultiBufferStart_IT(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint32_t SecondMemAddress, uint16_t DataLength)
+{
+	if (hdma->Init.DoubleBuffer != ENABLE || hdma->Init.Direction == DMA_MEMORY_TO_MEMORY)
+	{
+		return DMA_ERROR;
+	}
+
+	if (hdma->State != DMA_STATE_READY)
+	{
+		return DMA_BUSY;
+	}
+
+	hdma->State = DMA_STATE_BUSY;
+	hdma->ErrorCode = DMA_ERROR_NONE;
+
+	hdma->pStream->M1AR = SecondMemAddress;
+	DMA_SetConfig(hdma, SrcAddress, DstAddress, DataLength);
+	DMA_EnableInterrupts(hdma);
+	hdma->pStream->CR |= (1 << DMA_SxCR_EN);
+
+	return DMA_OK;
+}
+
+/**
+  * @brief  Changes the address of one memory in double-buffer mode while the stream runs.
+  *         Only the memory that is not the current target may be changed.
+  * @param  hdma Pointer to DMA handle.
+  * @param  Address New memory address.
+  * @param  Memory DMA_MEMORY_0 or DMA_MEMORY_1.
+  * @retval DMA_OK, or DMA_ERROR if that memory is in use.
+  */
+DMA_StatusTypeDef DMA_ChangeMemory(DMA_HandleTypeDef *hdma, uint32_t Address, uint8_t Memory)
+{
+	if ((hdma->pStream->CR & (1 << DMA_SxCR_EN)) && DMA_GetCurrentMemoryTarget(hdma) == Memory)
+	{
+		return DMA_ERROR;
+	}
+
+	if (Memory == DMA_MEMORY_0)
+		hdma->pStream->M0AR = Address;
+	else
+		hdma->pStream->M1AR = Address;
+
+	return DMA_OK;
+}
+
+/**
+  * @brief  Waits for the end of a transfer started with DMA_Start (normal mode only).
+  * @param  hdma Pointer to DMA handle.
+  * @param  Timeout Timeout in ms.
+  * @retval DMA_OK, DMA_ERROR on transfer error or timeout.
+  */
+DMA_StatusTypeDef DMA_PollForTransfer(DMA_HandleTypeDef *hdma, uint32_t Timeout)
+{
+	uint32_t start = getTick();
+	uint32_t flags;
+
+	do
+	{
+		flags = DMA_ReadFlags(hdma);
+
+		if (flags & (1 << DMA_ISR_TEIF))
+		{
+			DMA_ClearFlags(hdma, DMA_STREAM_FLAGS_MASK);
+			hdma->ErrorCode |= DMA_ERROR_TE;
+			hdma->State = DMA_STATE_READY;
+			return DMA_ERROR;
+		}
+
+		if ((getTick() - start) > Timeout)
+		{
+			DMA_Abort(hdma);
+			return DMA_ERROR;
+		}
+	} while (!(flags & (1 << DMA_ISR_TCIF)));
+
+	DMA_ClearFlags(hdma, (1 << DMA_ISR_TCIF) | (1 << DMA_ISR_HTIF));
+	hdma->State = DMA_STATE_READY;
+
+	return DMA_OK;
+}
+
+/**
+  * @brief  Stops an ongoing transfer.
+  * @param  hdma Pointer to DMA handle.
+  * @retval None
+  */
+void DMA_Abort(DMA_HandleTypeDef *hdma)
+{
+	hdma->pStream->CR &= ~((1 << DMA_SxCR_TCIE) | (1 << DMA_SxCR_HTIE) |
+			       (1 << DMA_SxCR_TEIE) | (1 << DMA_SxCR_DMEIE));
+	hdma->pStream->FCR &= ~(1 << DMA_SxFCR_FEIE);
+
+	DMA_DisableStream(hdma);
+	DMA_ClearFlags(hdma, DMA_STREAM_FLAGS_MASK);
+
+	hdma->State = DMA_STATE_READY;
+}
+
+/**
+  * @brief  Handles a DMA stream interrupt and calls the handle callbacks.
+  * @param  hdma Pointer to DMA handle.
+  * @retval None
+  */
+void DMA_IRQHandling(DMA_HandleTypeDef *hdma)
+{
+	uint32_t flags = DMA_ReadFlags(hdma);
+	uint32_t cr = hdma->pStream->CR;
+	uint8_t transferError = (flags & (1 << DMA_ISR_TEIF)) && (cr & (1 << DMA_SxCR_TEIE));
+
+	// 1. Transfer error: the hardware has already disabled the stream
+	if (transferError)
+	{
+		DMA_ClearFlags(hdma, (1 << DMA_ISR_TEIF));
+		hdma->pStream->CR &= ~(1 << DMA_SxCR_TEIE);
+		hdma->ErrorCode |= DMA_ERROR_TE;
+	}
+
+	// 2. FIFO error: under/overrun, the transfer continues
+	if ((flags & (1 << DMA_ISR_FEIF)) && (hdma->pStream->FCR & (1 << DMA_SxFCR_FEIE)))
+	{
+		DMA_ClearFlags(hdma, (1 << DMA_ISR_FEIF));
+		hdma->ErrorCode |= DMA_ERROR_FE;
+	}
+
+	// 3. Direct mode error
+	if ((flags & (1 << DMA_ISR_DMEIF)) && (cr & (1 << DMA_SxCR_DMEIE)))
+	{
+		DMA_ClearFlags(hdma, (1 << DMA_ISR_DMEIF));
+		hdma->ErrorCode |= DMA_ERROR_DME;
+	}
+
+	// 4. Half transfer
+	if ((flags & (1 << DMA_ISR_HTIF)) && (cr & (1 << DMA_SxCR_HTIE)))
+	{
+		DMA_ClearFlags(hdma, (1 << DMA_ISR_HTIF));
+		if (hdma->XferHalfCpltCallback != NULL)
+		{
+			hdma->XferHalfCpltCallback(hdma);
+		}
+	}
+
+	// 5. Transfer complete
+	if ((flags & (1 << DMA_ISR_TCIF)) && (cr & (1 << DMA_SxCR_TCIE)))
+	{
+		DMA_ClearFlags(hdma, (1 << DMA_ISR_TCIF));
+
+		if (cr & (1 << DMA_SxCR_DBM))
+		{
+			// CT has already switched: target 1 now means memory 0 was just completed
+			if (cr & (1 << DMA_SxCR_CT))
+			{
+				if (hdma->XferCpltCallback != NULL)
+					hdma->XferCpltCallback(hdma);
+			}
+			else
+			{
+				if (hdma->XferM1CpltCallback != NULL)
+					hdma->XferM1CpltCallback(hdma);
+			}
+		}
+		else
+		{
+			if (!(cr & (1 << DMA_SxCR_CIRC)))
+			{
+				hdma->pStream->CR &= ~((1 << DMA_SxCR_TCIE) | (1 << DMA_SxCR_HTIE) |
+						       (1 << DMA_SxCR_TEIE) | (1 << DMA_SxCR_DMEIE));
+				hdma->pStream->FCR &= ~(1 << DMA_SxFCR_FEIE);
+				hdma->State = DMA_STATE_READY;
+			}
+
+			if (hdma->XferCpltCallback != NULL)
+			{
+				hdma->XferCpltCallback(hdma);
+			}
+		}
+	}
+
+	// 6. Report errors that stopped the stream, once: ErrorCode keeps the cause for the
+	//    caller until the next start clears it
+	if (transferError)
+	{
+		hdma->State = DMA_STATE_READY;
+		if (hdma->XferErrorCallback != NULL)
+		{
+			hdma->XferErrorCallback(hdma);
+		}
+	}
+}
+
+
+/**
+  * @brief  Returns the registry index of a stream (0..7 DMA1, 8..15 DMA2).
+  */
+static uint8_t DMA_GetStreamIndex(DMA_Stream_RegDef_t *pStream)
+{
+	uintptr_t addr = (uintptr_t)pStream;
+	uint8_t index = ((addr & 0xFF) - 0x10) / 0x18;
+
+	return ((addr & ~0xFFUL) == DMA2_BASEADDR) ? (index + 8) : index;
+}
+
+/**
+  * @brief  Returns the controller a stream belongs to.
+  */
+static DMA_RegDef_t *DMA_GetController(DMA_Stream_RegDef_t *pStream)
+{
+	return (DMA_RegDef_t *)((uintptr_t)pStream & ~0xFFUL);
+}
+
+/**
+  * @brief  Reads the flags of the stream, aligned to the DMA_ISR_xxx bit positions.
+  */
+static uint32_t DMA_ReadFlags(DMA_HandleTypeDef *hdma)
+{
+	DMA_RegDef_t *pDMAx = DMA_GetController(hdma->pStream);
+	uint8_t stream = DMA_GetStreamIndex(hdma->pStream) % 8;
+	uint32_t isr = (stream < 4) ? pDMAx->LISR : pDMAx->HISR;
+
+	return (isr >> DMA_FlagShift[stream % 4]) & DMA_STREAM_FLAGS_MASK;
+}
+
+/**
+  * @brief  Clears flags of the stream (DMA_ISR_xxx bit positions).
+  */
+static void DMA_ClearFlags(DMA_HandleTypeDef *hdma, uint32_t Flags)
+{
+	DMA_RegDef_t *pDMAx = DMA_GetController(hdma->pStream);
+	uint8_t stream = DMA_GetStreamIndex(hdma->pStream) % 8;
+
+	// Write-one-to-clear, other streams are not affected
+	if (stream < 4)
+		pDMAx->LIFCR = (Flags & DMA_STREAM_FLAGS_MASK) << DMA_FlagShift[stream % 4];
+	else
+		pDMAx->HIFCR = (Flags & DMA_STREAM_FLAGS_MASK) << DMA_FlagShift[stream % 4];
+}
+
+/**
+  * @brief  Disables the stream and waits until the hardware releases it.
+  */
+static void DMA_DisableStream(DMA_HandleTypeDef *hdma)
+{
+	hdma->pStream->CR &= ~(1 << DMA_SxCR_EN);
+	while (hdma->pStream->CR & (1 << DMA_SxCR_EN));
+}
+
+/**
+  * @brief  Programs the addresses and length of a transfer.
+  */
+static void DMA_SetConfig(DMA_HandleTypeDef *hdma, uint32_t SrcAddress, uint32_t DstAddress, uint16_t DataLength)
+{
+	DMA_DisableStream(hdma);
+	DMA_ClearFlags(hdma, DMA_STREAM_FLAGS_MASK);
+
+	hdma->pStream->NDTR = DataLength;
+
+	if (hdma->Init.Direction == DMA_MEMORY_TO_PERIPH)
+	{
+		hdma->pStream->PAR = DstAddress;
+		hdma->pStream->M0AR = SrcAddress;
+	}
+	else
+	{
+		// Peripheral to memory, and memory to memory (PAR is the source)
+		hdma->pStream->PAR = SrcAddress;
+		hdma->pStream->M0AR = DstAddress;
+	}
+}
+
+/**
+  * @brief  Enables the stream interrupts used by DMA_IRQHandling.
+  */
+static void DMA_EnableInterrupts(DMA_HandleTypeDef *hdma)
+{
+	uint32_t cr = hdma->pStream->CR;
+
+	cr |= (1 << DMA_SxCR_TCIE) | (1 << DMA_SxCR_TEIE) | (1 << DMA_SxCR_DMEIE);
+	if (hdma->XferHalfCpltCallback != NULL)
+		cr |= (1 << DMA_SxCR_HTIE);
+	else
+		cr &= ~(1 << DMA_SxCR_HTIE);
+	hdma->pStream->CR = cr;
+
+	if (hdma->Init.FIFOMode == ENABLE)
+		hdma->pStream->FCR |= (1 << DMA_SxFCR_FEIE);
+}
+
+
+/*
+ * Stream interrupt vectors, dispatched to the registered handles
+ */
+static void DMA_Dispatch(uint8_t index)
+{
+	if (DMA_Registry[index] != NULL)
+	{
+		DMA_IRQHandling(DMA_Registry[index]);
+	}
+}
+
+void DMA1_Stream0_IRQHandler(void) { DMA_Dispatch(0); }
+void DMA1_Stream1_IRQHandler(void) { DMA_Dispatch(1); }
+void DMA1_Stream2_IRQHandler(void) { DMA_Dispatch(2); }
+void DMA1_Stream3_IRQHandler(void) { DMA_Dispatch(3); }
+void DMA1_Stream4_IRQHandler(void) { DMA_Dispatch(4); }
+void DMA1_Stream5_IRQHandler(void) { DMA_Dispatch(5); }
+void DMA1_Stream6_IRQHandler(void) { DMA_Dispatch(6); }
+void DMA1_Stream7_IRQHandler(void) { DMA_Dispatch(7); }
+void DMA2_Stream0_IRQHandler(void) { DMA_Dispatch(8); }
+void DMA2_Stream1_IRQHandler(void) { DMA_Dispatch(9); }
+void DMA2_Stream2_IRQHandler(void) { DMA_Dispatch(10); }
+void DMA2_Stream3_IRQHandler(void) { DMA_Dispatch(11); }
+void DMA2_Stream4_IRQHandler(void) { DMA_Dispatch(12); }
+void DMA2_Stream5_IRQHandler(void) { DMA_Dispatch(13); }
+void DMA2_Stream6_IRQHandler(void) { DMA_Dispatch(14); }
+void DMA2_Stream7_IRQHandler(void) { DMA_Dispatch(15); }
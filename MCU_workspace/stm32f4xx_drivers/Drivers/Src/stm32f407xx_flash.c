@@ -0,0 +1,128 @@
+/*
+ * stm32f407xx_flash.c
+ */
+
+#include "stm32f407xx_flash.h"
+
+#define FLASH_SR_ERRORS		((1 << FLASH_SR_OPERR) | (1 << FLASH_SR_WRPERR) | (1 << FLASH_SR_PGAERR) | \
+							 (1 << FLASH_SR_PGPERR) | (1 << FLASH_SR_PGSERR))
+
+static FLASH_StatusTypeDef FLASH_WaitForLastOperation(void);
+
+/**
+  * @brief  Unlocks the flash control register.
+  * @retval None
+  */
+void FLASH_Unlock(void)
+{
+	if (FLASH_INTF->CR & (1UL << FLASH_CR_LOCK))
+	{
+		FLASH_INTF->KEYR = FLASH_KEY1;
+		FLASH_INTF->KEYR = FLASH_KEY2;
+	}
+}
+
+/**
+  * @brief  Locks the flash control register again.
+  * @retval None
+  */
+void FLASH_Lock(void)
+{
+	FLASH_INTF->CR |= (1UL << FLASH_CR_LOCK);
+}
+
+/**
+  * @brief  Erases one sector. The flash must be unlocked.
+  * @param  Sector Sector number (0..11).
+  * @retval FLASH_OK, FLASH_ERROR on a protection or sequence error.
+  */
+FLASH_StatusTypeDef FLASH_EraseSector(uint8_t Sector)
+{
+	FLASH_StatusTypeDef status;
+
+	if (Sector >= FLASH_SECTOR_COUNT)
+	{
+		return FLASH_ERROR;
+	}
+
+	if (FLASH_WaitForLastOperation() != FLASH_OK)
+	{
+		return FLASH_ERROR;
+	}
+
+	FLASH_INTF->CR &= ~((0x3 << FLASH_CR_PSIZE) | (0xF << FLASH_CR_SNB));
+	FLASH_INTF->CR |= (FLASH_PSIZE_WORD << FLASH_CR_PSIZE) | (Sector << FLASH_CR_SNB) | (1 << FLASH_CR_SER);
+	FLASH_INTF->CR |= (1 << FLASH_CR_STRT);
+
+	status = FLASH_WaitForLastOperation();
+	FLASH_INTF->CR &= ~((1 << FLASH_CR_SER) | (0xF << FLASH_CR_SNB));
+
+	return status;
+}
+
+/**
+  * @brief  Programs one word. The flash must be unlocked and the word erased.
+  * @param  Address Word aligned address.
+  * @param  Data Value to program.
+  * @retval FLASH_OK, FLASH_ERROR on a protection, alignment or sequence error.
+  */
+FLASH_StatusTypeDef FLASH_ProgramWord(uint32_t Address, uint32_t Data)
+{
+	FLASH_StatusTypeDef status;
+
+	if (FLASH_WaitForLastOperation() != FLASH_OK)
+	{
+		return FLASH_ERROR;
+	}
+
+	FLASH_INTF->CR &= ~(0x3 << FLASH_CR_PSIZE);
+	FLASH_INTF->CR |= (FLASH_PSIZE_WORD << FLASH_CR_PSIZE) | (1 << FLASH_CR_PG);
+
+	*(__vo uint32_t*)(uintptr_t)Address = Data;
+
+	status = FLASH_WaitForLastOperation();
+	FLASH_INTF->CR &= ~(1 << FLASH_CR_PG);
+
+	return status;
+}
+
+/**
+  * @brief  Programs consecutive words. The flash must be unlocked and the area erased.
+  * @param  Address Word aligned start address.
+  * @param  pData Words to program.
+  * @param  WordCount Number of words.
+  * @retval FLASH_OK, FLASH_ERROR at the first failing word.
+  */
+FLASH_StatusTypeDef FLASH_Program(uint32_t Address, const uint32_t *pData, uint32_t WordCount)
+{
+	for (uint32_t i = 0; i < WordCount; i++)
+	{
+		if (FLASH_ProgramWord(Address + 4 * i, pData[i]) != FLASH_OK)
+		{
+			return FLASH_ERROR;
+		}
+	}
+
+	return FLASH_OK;
+}
+
+
+/**
+  * @brief  Waits until the flash is idle and reports the errors of the last operation.
+  * @note   No timeout: the CPU stalls on flash fetches while BSY is set, the tick does not run.
+  */
+static FLASH_StatusTypeDef FLASH_WaitForLastOperation(void)
+{
+	while (FLASH_INTF->SR & (1UL << FLASH_SR_BSY));
+
+	uint32_t errors = FLASH_INTF->SR & FLASH_SR_ERRORS;
+	if (errors)
+	{
+		// Error flags are cleared by writing 1
+		FLASH_INTF->SR = errors;
+		return FLASH_ERROR;
+	}
+
+	FLASH_INTF->SR = (1 << FLASH_SR_EOP);
+	return FLASH_OK;
+}
@@ -347,6 +347,7 @@ uint16_t GPIO_ReadPort(GPIO_RegDef_t *pGPIOx)
 }
 /**
   * @brief  Sets or clears the selected GPIO pin.
+  * @note   Uses BSRR, so the write is atomic and leaves the other pins of the port untouched.
   * @param  GPIOx where x can be (A..I) to select the GPIO peripheral.
   * @param  GPIO_Pin specifies the bit to be written.
   *          This parameter can be one of GPIO_PIN_x where x can be (0..15).
@@ -359,13 +360,26 @@ uint16_t GPIO_ReadPort(GPIO_RegDef_t *pGPIOx)
 void GPIO_WritePin(GPIO_RegDef_t *pGPIOx, uint8_t GPIO_pin, uint8_t pinState)
 {
 	if (pinState == GPIO_PIN_SET) {
-		//write 1 to the output data register at the bit field corresponding to the pin number
-		pGPIOx->ODR = (1 << GPIO_pin);
+		// BS field (bits 15:0) sets the pin
+		pGPIOx->BSRR = (1 << GPIO_pin);
 	}else {
-		// write 0
-		pGPIOx->ODR &= ~(1 << GPIO_pin);
+		// BR field (bits 31:16) resets the pin
+		pGPIOx->BSRR = (1 << (GPIO_pin + 16));
 	}
 }
+
+/**
+  * @brief  Sets and resets several pins of one port with a single store.
+  * @note   If a pin is in both masks, it is set (BS has priority over BR).
+  * @param  pGPIOx where x can be (A..I) to select the GPIO peripheral.
+  * @param  SetMask bit mask of the pins to set.
+  * @param  ResetMask bit mask of the pins to reset.
+  * @retval None
+  */
+void GPIO_WritePins(GPIO_RegDef_t *pGPIOx, uint16_t SetMask, uint16_t ResetMask)
+{
+	pGPIOx->BSRR = ((uint32_t)ResetMask << 16) | SetMask;
+}
 /**
   * @brief  Writes a 16-bit value to the entire GPIO port.
   * @param  GPIOx where x can be (A..I) to select the GPIO peripheral.
@@ -386,7 +400,10 @@ void GPIO_WritePort(GPIO_RegDef_t *pGPIOx, uint16_t GPIO_pin)
   */
 void GPIO_TogglePin(GPIO_RegDef_t* pGPIOx, uint8_t GPIO_pin)
 {
-	pGPIOx->ODR ^= (1 << GPIO_pin);
+	uint32_t odr = pGPIOx->ODR;
+
+	// Only the selected pin is written, an ISR changing another pin of the port is not undone
+	pGPIOx->BSRR = (odr & (1 << GPIO_pin)) ? (1 << (GPIO_pin + 16)) : (1 << GPIO_pin);
 }
 
 /**
@@ -397,58 +414,18 @@ void GPIO_TogglePin(GPIO_RegDef_t* pGPIOx, uint8_t GPIO_pin)
   */
 void GPIO_IRQInterruptConfig(uint8_t IRQNumber, uint8_t state)
 {
-
-    if(state == ENABLE)
-    {
-        if(IRQNumber <= 31)
-        {
-            //program ISER0 register
-            *NVIC_ISER0 |= ( 1 << IRQNumber );
-
-        }else if(IRQNumber > 31 && IRQNumber < 64 ) //32 to 63
-        {
-            //program ISER1 register
-            *NVIC_ISER1 |= ( 1 << (IRQNumber % 32) );
-        }
-        else if(IRQNumber >= 64 && IRQNumber < 96 )
-        {
-            //program ISER2 register //64 to 95
-            *NVIC_ISER2 |= ( 1 << (IRQNumber % 64) );
-        }
-    }else
-    {
-        if(IRQNumber <= 31)
-        {
-            //program ICER0 register
-            *NVIC_ICER0 |= ( 1 << IRQNumber );
-        }else if(IRQNumber > 31 && IRQNumber < 64 )
-        {
-            //program ICER1 register
-            *NVIC_ICER1 |= ( 1 << (IRQNumber % 32) );
-        }
-        else if(IRQNumber >= 64 && IRQNumber < 96 )
-        {
-            //program ICER2 register
-            *NVIC_ICER2 |= ( 1 << (IRQNumber % 64) );
-        }
-    }
+	NVIC_IRQInterruptConfig(IRQNumber, state);
 }
 
 /**
   * @brief  Configures the priority of an IRQ.
   * @param  IRQNumber Specifies the IRQ number.
-  * @param  IRQPriority Specifies the priority level (0-255, lower is higher priority).
+  * @param  IRQPriority Specifies the priority level (0-15, lower is higher priority), see @ref IRQ_Priority_Plan.
   * @retval None
   */
 void GPIO_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority)
 {
-	// lets find out the IPR register
-	uint8_t iprx = IRQNumber / 4;
-	uint8_t ipr_section = IRQNumber % 4;
-
-	uint8_t shift_amount = (8 * ipr_section) + (8 - NO_PR_BITS_IMPLEMENTED);
-	*(NVIC_PR_BASEADDR + iprx) &= ~(0xFF << shift_amount);
-	*(NVIC_PR_BASEADDR  + iprx) |= (IRQPriority << shift_amount);
+	NVIC_IRQPriorityConfig(IRQNumber, (uint8_t)IRQPriority);
 }
 
 /**
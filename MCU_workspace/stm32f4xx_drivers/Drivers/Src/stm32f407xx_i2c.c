@@ -27,7 +27,8 @@ static void I2C_MasterReceive_BTF(I2C_HandleTypeDef *hi2c);
  void I2C1_Init(I2C_HandleTypeDef *hi2c1)
 {
   hi2c1->pI2Cx = I2C1;
-  hi2c1->Init.ClockSpeed = I2C_CLOCKSPEED_SM;
+  //Fast mode: a 14-byte MPU6050 read takes ~0.45 ms instead of ~1.6 ms, well inside the 2 ms balance loop
+  hi2c1->Init.ClockSpeed = I2C_CLOCK_PEED_FM4K;
   hi2c1->Init.DutyCycle = I2C_DUTYCYCLE_2;
   hi2c1->Init.DeviceAddress = MPU6050_ADDRESS;
   hi2c1->Init.AckControl = I2C_ACK_ENABLE;
@@ -409,10 +410,11 @@ I2C_StatusTypeDef I2C_Init(I2C_HandleTypeDef *hi2c)
         tempreg |= 1 << 15;
         tempreg |= (hi2c->Init.DutyCycle << 14);
 
-        if (hi2c->Init.DutyCycle == I2C_DUTYCYCLE_2) {
-            CCR_value = (RCC_GetPCLK1_Value() / (3 * hi2c->Init.ClockSpeed));  // Calculate CCR value for DutyCycle 2:1
-        } else {
-            CCR_value = (RCC_GetPCLK1_Value() / (25 * hi2c->Init.ClockSpeed));  // Calculate CCR value for DutyCycle 16:9
+        // Rounded up so that the bus never runs above the requested speed (16 MHz PCLK1: 381 kHz)
+        uint32_t divider = (hi2c->Init.DutyCycle == I2C_DUTYCYCLE_2) ? 3 : 25;  // DutyCycle 2:1 or 16:9
+        CCR_value = (RCC_GetPCLK1_Value() + divider * hi2c->Init.ClockSpeed - 1) / (divider * hi2c->Init.ClockSpeed);
+        if (CCR_value < 1) {
+            CCR_value = 1;
         }
     }
 
@@ -425,7 +427,8 @@ I2C_StatusTypeDef I2C_Init(I2C_HandleTypeDef *hi2c)
         tempreg = (RCC_GetPCLK1_Value() / 1000000U) + 1;
     } else {
         // Fast Mode (400 kHz)
-        tempreg = ((RCC_GetPCLK1_Value() * 300) / 1000000000U) + 1;
+        // 300 ns max rise time, in MHz first: PCLK1 * 300 overflows 32 bits
+        tempreg = (((RCC_GetPCLK1_Value() / 1000000U) * 300) / 1000U) + 1;
     }
     hi2c->pI2Cx->TRISE = (tempreg & 0x3F);
 
@@ -729,58 +732,18 @@ void I2C_PeripheralControl(I2C_RegDef_t *pI2Cx, uint8_t controlState)
   */
 void I2C_IRQInterruptConfig(uint8_t IRQNumber, uint8_t state)
 {
-
-    if(state == ENABLE)
-    {
-        if(IRQNumber <= 31)
-        {
-            //program ISER0 register
-            *NVIC_ISER0 |= ( 1 << IRQNumber );
-
-        }else if(IRQNumber > 31 && IRQNumber < 64 ) //32 to 63
-        {
-            //program ISER1 register
-            *NVIC_ISER1 |= ( 1 << (IRQNumber % 32) );
-        }
-        else if(IRQNumber >= 64 && IRQNumber < 96 )
-        {
-            //program ISER2 register //64 to 95
-            *NVIC_ISER3 |= ( 1 << (IRQNumber % 64) );
-        }
-    }else
-    {
-        if(IRQNumber <= 31)
-        {
-            //program ICER0 register
-            *NVIC_ICER0 |= ( 1 << IRQNumber );
-        }else if(IRQNumber > 31 && IRQNumber < 64 )
-        {
-            //program ICER1 register
-            *NVIC_ICER1 |= ( 1 << (IRQNumber % 32) );
-        }
-        else if(IRQNumber >= 6 && IRQNumber < 96 )
-        {
-            //program ICER2 register
-            *NVIC_ICER3 |= ( 1 << (IRQNumber % 64) );
-        }
-    }
+	NVIC_IRQInterruptConfig(IRQNumber, state);
 }
 
 /**
   * @brief  Configures the priority of an IRQ.
   * @param  IRQNumber Specifies the IRQ number.
-  * @param  IRQPriority Specifies the priority level (0-255, lower is higher priority).
+  * @param  IRQPriority Specifies the priority level (0-15, lower is higher priority), see @ref IRQ_Priority_Plan.
   * @retval None
   */
 void I2C_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority)
 {
-    //1. first lets find out the ipr register
-    uint8_t iprx = IRQNumber / 4;
-    uint8_t iprx_section  = IRQNumber %4 ;
-
-    uint8_t shift_amount = ( 8 * iprx_section) + ( 8 - NO_PR_BITS_IMPLEMENTED) ;
-
-    *(  NVIC_PR_BASEADDR + iprx ) |=  ( IRQPriority << shift_amount );
+	NVIC_IRQPriorityConfig(IRQNumber, (uint8_t)IRQPriority);
 }
 
 /**
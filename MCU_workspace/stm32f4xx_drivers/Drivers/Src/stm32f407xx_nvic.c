@@ -0,0 +1,155 @@
+/*
+ * stm32f407xx_nvic.c
+ *
+ *  Created on: Jul 6, 2025
+ *      Author: nhduong
+ */
+
+#include "stm32f407xx_nvic.h"
+
+/**
+  * @brief  Enables or disables the specified IRQ number.
+  * @note   ISER/ICER are write-one registers: zero bits have no effect, so a plain store
+  *         is used instead of a read-modify-write.
+  * @param  IRQNumber Specifies the IRQ number (0..81).
+  * @param  state ENABLE or DISABLE the IRQ.
+  * @retval None
+  */
+void NVIC_IRQInterruptConfig(uint8_t IRQNumber, uint8_t state)
+{
+	if (state == ENABLE)
+	{
+		*(NVIC_ISER0 + (IRQNumber / 32)) = (1UL << (IRQNumber % 32));
+	}else
+	{
+		*(NVIC_ICER0 + (IRQNumber / 32)) = (1UL << (IRQNumber % 32));
+	}
+}
+
+/**
+  * @brief  Configures the priority of an IRQ.
+  * @note   Each IRQ owns one byte of the IPR registers, a byte store leaves the neighbours untouched.
+  * @param  IRQNumber Specifies the IRQ number.
+  * @param  IRQPriority Specifies the priority level (0-15, lower is higher priority).
+  *         See @ref IRQ_Priority_Plan.
+  * @retval None
+  */
+void NVIC_IRQPriorityConfig(uint8_t IRQNumber, uint8_t IRQPriority)
+{
+	NVIC_IPR_BYTE_BASEADDR[IRQNumber] = (uint8_t)(IRQPriority << (8 - NO_PR_BITS_IMPLEMENTED));
+}
+
+/**
+  * @brief  Returns the priority of an IRQ.
+  * @param  IRQNumber Specifies the IRQ number.
+  * @retval Priority level (0-15).
+  */
+uint8_t NVIC_GetPriority(uint8_t IRQNumber)
+{
+	return NVIC_IPR_BYTE_BASEADDR[IRQNumber] >> (8 - NO_PR_BITS_IMPLEMENTED);
+}
+
+/**
+  * @brief  Sets the pending bit of an IRQ (software triggered interrupt).
+  * @param  IRQNumber Specifies the IRQ number.
+  * @retval None
+  */
+void NVIC_SetPendingIRQ(uint8_t IRQNumber)
+{
+	*(NVIC_ISPR0 + (IRQNumber / 32)) = (1UL << (IRQNumber % 32));
+}
+
+/**
+  * @brief  Clears the pending bit of an IRQ.
+  * @param  IRQNumber Specifies the IRQ number.
+  * @retval None
+  */
+void NVIC_ClearPendingIRQ(uint8_t IRQNumber)
+{
+	*(NVIC_ICPR0 + (IRQNumber / 32)) = (1UL << (IRQNumber % 32));
+}
+
+/**
+  * @brief  Reads the pending bit of an IRQ.
+  * @param  IRQNumber Specifies the IRQ number.
+  * @retval 1 if the IRQ is pending, 0 otherwise.
+  */
+uint8_t NVIC_GetPendingIRQ(uint8_t IRQNumber)
+{
+	return (*(NVIC_ISPR0 + (IRQNumber / 32)) >> (IRQNumber % 32)) & 0x1;
+}
+
+/**
+  * @brief  Reads the active bit of an IRQ.
+  * @param  IRQNumber Specifies the IRQ number.
+  * @retval 1 if the IRQ handler is running or preempted, 0 otherwise.
+  */
+uint8_t NVIC_GetActive(uint8_t IRQNumber)
+{
+	return (*(NVIC_IABR0 + (IRQNumber / 32)) >> (IRQNumber % 32)) & 0x1;
+}
+
+/**
+  * @brief  Sets the split between preemption priority and subpriority.
+  * @param  PriorityGroup value of @ref NVIC_Priority_Group.
+  * @retval None
+  */
+void NVIC_SetPriorityGrouping(uint32_t PriorityGroup)
+{
+	uint32_t temp = SCB_AIRCR;
+
+	temp &= ~(SCB_AIRCR_VECTKEY_MASK | SCB_AIRCR_PRIGROUP_MASK);
+	temp |= SCB_AIRCR_VECTKEY | ((PriorityGroup & 0x7) << SCB_AIRCR_PRIGROUP_Pos);
+	SCB_AIRCR = temp;
+}
+
+/**
+  * @brief  Returns the current priority grouping.
+  * @retval Value of @ref NVIC_Priority_Group.
+  */
+uint32_t NVIC_GetPriorityGrouping(void)
+{
+	return (SCB_AIRCR & SCB_AIRCR_PRIGROUP_MASK) >> SCB_AIRCR_PRIGROUP_Pos;
+}
+
+/**
+  * @brief  Builds a priority level from a preemption priority and a subpriority.
+  * @param  PriorityGroup value of @ref NVIC_Priority_Group.
+  * @param  PreemptPriority preemption priority within the bits of the group.
+  * @param  SubPriority subpriority within the remaining bits.
+  * @retval Priority level to pass to NVIC_IRQPriorityConfig.
+  */
+uint8_t NVIC_EncodePriority(uint32_t PriorityGroup, uint8_t PreemptPriority, uint8_t SubPriority)
+{
+	uint32_t group = PriorityGroup & 0x7;
+	uint32_t preemptBits = ((7 - group) > NO_PR_BITS_IMPLEMENTED) ? NO_PR_BITS_IMPLEMENTED : (7 - group);
+	uint32_t subBits = ((group + NO_PR_BITS_IMPLEMENTED) < 7) ? 0 : (group - 7 + NO_PR_BITS_IMPLEMENTED);
+
+	return (uint8_t)(((PreemptPriority & ((1UL << preemptBits) - 1)) << subBits) |
+			  (SubPriority & ((1UL << subBits) - 1)));
+}
+
+/**
+  * @brief  Configures the priority of the SysTick exception.
+  * @param  Priority Specifies the priority level (0-15, lower is higher priority).
+  * @retval None
+  */
+void NVIC_SysTickPriorityConfig(uint8_t Priority)
+{
+	uint32_t temp = SCB_SHPR3;
+
+	temp &= ~(0xFFUL << SCB_SHPR3_SYSTICK_Pos);
+	temp |= ((uint32_t)(Priority << (8 - NO_PR_BITS_IMPLEMENTED)) & 0xFF) << SCB_SHPR3_SYSTICK_Pos;
+	SCB_SHPR3 = temp;
+}
+
+/**
+  * @brief  Applies the interrupt priority plan: all priority bits are preemption bits and
+  *         SysTick gets the highest level. Call once before enabling any interrupt.
+  * @retval None
+  */
+void NVIC_Init(void)
+{
+	NVIC_SetPriorityGrouping(NVIC_PRIORITYGROUP_4);
+	NVIC_SysTickPriorityConfig(IRQ_PRIO_CONTROL_TICK);
+}
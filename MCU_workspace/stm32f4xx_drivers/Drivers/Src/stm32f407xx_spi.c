@@ -10,6 +10,8 @@
 static void spi_txe_interrupt_handler(SPI_HandleTypeDef *hspi);
 static void spi_rxne_interrupt_handler(SPI_HandleTypeDef *hspi);
 static void spi_ovr_error_interrupt_handler(SPI_HandleTypeDef *hspi);
+static void spi_dma_tx_cplt(DMA_HandleTypeDef *hdma);
+static void spi_dma_tx_error(DMA_HandleTypeDef *hdma);
 
 /**
  * @brief  Enables or disables the clock for the specified SPI peripheral.
@@ -501,55 +503,69 @@ uint8_t SPI_Receive_IT(SPI_HandleTypeDef *hspi, uint8_t *pRxBuffer,
 	return state;
 }
 
+/**
+ * @brief  Transmit an amount of data in non-blocking mode with DMA.
+ * @note   hspi->hdmatx must be initialized (DMA_MEMORY_TO_PERIPH, memory increment,
+ *         data size matching the SPI frame). SPI is enabled and left enabled, so
+ *         back-to-back transfers do not pay for SPE toggling.
+ * @param  hspi pointer to a SPI_HandleTypeDef structure that contains
+ *               the configuration information for SPI module.
+ * @param  pTxBuffer pointer to data buffer, must stay valid until completion
+ * @param  Len number of frames to be sent
+ * @retval SPI_STATE_READY if the transfer started, SPI_STATE_BUSY_TX if one is
+ *         already running, SPI_STATE_ERROR if the stream could not start
+ */
+uint8_t SPI_Transmit_DMA(SPI_HandleTypeDef *hspi, const uint8_t *pTxBuffer,
+		uint16_t Len) {
+	uint8_t state = hspi->TxState;
+
+	if (hspi->hdmatx == NULL || Len == 0) {
+		return SPI_STATE_ERROR;
+	}
+
+	if (state != SPI_STATE_BUSY_TX) {
+		hspi->pTxBuffer = pTxBuffer;
+		hspi->TxLen = Len;
+		hspi->TxState = SPI_STATE_BUSY_TX;
+
+		hspi->hdmatx->Parent = hspi;
+		hspi->hdmatx->XferCpltCallback = spi_dma_tx_cplt;
+		hspi->hdmatx->XferHalfCpltCallback = NULL;
+		hspi->hdmatx->XferErrorCallback = spi_dma_tx_error;
+
+		if (DMA_Start_IT(hspi->hdmatx, (uint32_t)(uintptr_t)pTxBuffer,
+				(uint32_t)(uintptr_t)&hspi->pSPIx->DR, Len) != DMA_OK) {
+			hspi->TxState = SPI_STATE_READY;
+			return SPI_STATE_ERROR;
+		}
+
+		// TXE requests start the stream as soon as TXDMAEN is set
+		SPI_PeripheralControl(hspi->pSPIx, ENABLE);
+		hspi->pSPIx->CR2 |= (1 << SPI_CR2_TXDMAEN);
+	}
+	return state;
+}
+
 /**
  * @brief  Enables or disables the specified IRQ number.
  * @param  IRQNumber Specifies the IRQ number.
  * @param  state ENABLE or DISABLE the IRQ.
  * @retval None
  */
-void SPI_IRQInterruptConfig(uint8_t IRQNumber, uint8_t state) {
-
-	if (state == ENABLE) {
-		if (IRQNumber <= 31) {
-			//program ISER0 register
-			*NVIC_ISER0 |= (1 << IRQNumber);
-
-		} else if (IRQNumber > 31 && IRQNumber < 64) //32 to 63
-				{
-			//program ISER1 register
-			*NVIC_ISER1 |= (1 << (IRQNumber % 32));
-		} else if (IRQNumber >= 64 && IRQNumber < 96) {
-			//program ISER2 register //64 to 95
-			*NVIC_ISER2 |= (1 << (IRQNumber % 64));
-		}
-	} else {
-		if (IRQNumber <= 31) {
-			//program ICER0 register
-			*NVIC_ICER0 |= (1 << IRQNumber);
-		} else if (IRQNumber > 31 && IRQNumber < 64) {
-			//program ICER1 register
-			*NVIC_ICER1 |= (1 << (IRQNumber % 32));
-		} else if (IRQNumber >= 64 && IRQNumber < 96) {
-			//program ICER2 register
-			*NVIC_ICER2 |= (1 << (IRQNumber % 64));
-		}
-	}
+void SPI_IRQInterruptConfig(uint8_t IRQNumber, uint8_t state)
+{
+	NVIC_IRQInterruptConfig(IRQNumber, state);
 }
 
 /**
  * @brief  Configures the priority of an IRQ.
  * @param  IRQNumber Specifies the IRQ number.
- * @param  IRQPriority Specifies the priority level (0-255, lower is higher priority).
+ * @param  IRQPriority Specifies the priority level (0-15, lower is higher priority), see @ref IRQ_Priority_Plan.
  * @retval None
  */
-void SPI_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority) {
-	// lets find out the IPR register
-	uint8_t iprx = IRQNumber / 4;
-	uint8_t ipr_section = IRQNumber % 4;
-
-	uint8_t shift_amount = (8 * ipr_section) + (8 - NO_PR_BITS_IMPLEMENTED);
-	*(NVIC_PR_BASEADDR + iprx) &= ~(0xFF << shift_amount);
-	*(NVIC_PR_BASEADDR + iprx) |= (IRQPriority << shift_amount);
+void SPI_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority)
+{
+	NVIC_IRQPriorityConfig(IRQNumber, (uint8_t)IRQPriority);
 }
 
 /**
@@ -647,6 +663,54 @@ static void spi_ovr_error_interrupt_handler(SPI_HandleTypeDef *hspi) {
 	SPI_ApplicationEventCallback(hspi, SPI_EVENT_OVR_ERROR);
 }
 
+/**
+ * @brief  DMA transfer complete of SPI_Transmit_DMA.
+ * @note   The stream completes when the last frame is written to DR, the frame
+ *         still has to be shifted out (at most two frame times) before the
+ *         transfer is reported complete.
+ */
+static void spi_dma_tx_cplt(DMA_HandleTypeDef *hdma) {
+	SPI_HandleTypeDef *hspi = (SPI_HandleTypeDef*) hdma->Parent;
+
+	while (!SPI_GetFlagStatus(hspi->pSPIx, SPI_FLAG_TXE))
+		;
+	while (SPI_GetFlagStatus(hspi->pSPIx, SPI_FLAG_BSY))
+		;
+
+	hspi->pSPIx->CR2 &= ~(1 << SPI_CR2_TXDMAEN);
+
+	// Received frames were never read
+	SPI_ClearOVRFlag(hspi->pSPIx);
+
+	hspi->pTxBuffer = NULL;
+	hspi->TxLen = 0;
+	hspi->TxState = SPI_STATE_READY;
+
+	if (hspi->TxCpltCallback != NULL) {
+		hspi->TxCpltCallback(hspi);
+	} else {
+		SPI_ApplicationEventCallback(hspi, SPI_EVENT_TX_COMPLETE);
+	}
+}
+
+/**
+ * @brief  DMA transfer error of SPI_Transmit_DMA.
+ */
+static void spi_dma_tx_error(DMA_HandleTypeDef *hdma) {
+	SPI_HandleTypeDef *hspi = (SPI_HandleTypeDef*) hdma->Parent;
+
+	hspi->pSPIx->CR2 &= ~(1 << SPI_CR2_TXDMAEN);
+	hspi->pTxBuffer = NULL;
+	hspi->TxLen = 0;
+	hspi->TxState = SPI_STATE_READY;
+
+	if (hspi->TxErrorCallback != NULL) {
+		hspi->TxErrorCallback(hspi);
+	} else {
+		SPI_ApplicationEventCallback(hspi, SPI_EVENT_DMA_ERROR);
+	}
+}
+
 void SPI_CloseTransmisson(SPI_HandleTypeDef *hspi) {
 	hspi->pSPIx->CR2 &= ~(1 << SPI_CR2_TXEIE);
 	hspi->pTxBuffer = NULL;
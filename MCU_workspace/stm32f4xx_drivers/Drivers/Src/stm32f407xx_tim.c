@@ -10,6 +10,32 @@
 // TIM_Private_Functions
 static void TIM_SetCounterMode(TIM_RegDef_t *TIMx, uint8_t Mode);
 static void TIM_CounterControl(TIM_RegDef_t *pTIMx, uint8_t State);
+static void TIM_MainOutputEnable(TIM_RegDef_t *TIMx);
+
+/*
+ * Capture/compare pin mapping of each general purpose/advanced timer.
+ * All four channels of a timer are routed to the same port.
+ */
+typedef struct
+{
+	TIM_RegDef_t	*pTIMx;		/*!< Timer instance					*/
+	GPIO_RegDef_t	*pGPIOx;	/*!< Port carrying CH1..CH4			*/
+	uint8_t			Pin[4];		/*!< Pin number of CH1..CH4			*/
+	uint8_t			Alternate;	/*!< Alternate function number		*/
+}TIM_PinMap_t;
+
+static const TIM_PinMap_t TIM_PinMap[] =
+{
+	{ TIM1, GPIOE, { GPIO_PIN_9,  GPIO_PIN_11, GPIO_PIN_13, GPIO_PIN_14 }, AF1 },
+	{ TIM2, GPIOA, { GPIO_PIN_0,  GPIO_PIN_1,  GPIO_PIN_2,  GPIO_PIN_3  }, AF1 },
+	{ TIM3, GPIOB, { GPIO_PIN_4,  GPIO_PIN_5,  GPIO_PIN_0,  GPIO_PIN_1  }, AF2 },
+	{ TIM4, GPIOD, { GPIO_PIN_12, GPIO_PIN_13, GPIO_PIN_14, GPIO_PIN_15 }, AF2 },
+	{ TIM5, GPIOA, { GPIO_PIN_0,  GPIO_PIN_1,  GPIO_PIN_2,  GPIO_PIN_3  }, AF2 },
+	{ TIM8, GPIOC, { GPIO_PIN_6,  GPIO_PIN_7,  GPIO_PIN_8,  GPIO_PIN_9  }, AF3 },
+	{ TIM9, GPIOE, { GPIO_PIN_5,  GPIO_PIN_6,  TIM_PIN_NONE, TIM_PIN_NONE }, AF3 },
+};
+
+static const TIM_PinMap_t *TIM_GetPinMap(TIM_RegDef_t *TIMx);
 
 /**
   * @brief  Initializes the TIMx peripheral according to the specified parameters in the TIMx_Init.
@@ -65,7 +91,7 @@ void TIM_PeriClockControl(TIM_RegDef_t *pTIMx, uint8_t clockState)
 void TIM_SetEncoderMode(TIM_RegDef_t *pTIMx, uint8_t EncoderMode)
 {
     // 1. Clear SMS bits
-    pTIMx->SMCR &= ~TIM_SMCR_SMS_Pos;
+    pTIMx->SMCR &= ~(TIM_SMCR_SMS_MASK << TIM_SMCR_SMS_Pos);
 
     // 2. Set encoder mode
     switch (EncoderMode)
@@ -123,21 +149,19 @@ void TIM_SetConfigEncoder(TIM_RegDef_t *pTIMx,
     TIM_SetEncoderMode(pTIMx, EncoderMode);
 
     // 7. Configure Input Capture mode
-    pTIMx->CCMR1 &= ~(TIM_CCMR1_CC1S_Pos | TIM_CCMR1_CC2S_Pos);
-    pTIMx->CCMR1 |= (1 << TIM_CCMR1_CC1S_Pos) | (1 << TIM_CCMR1_CC2S_Pos);
+    TIM_SetICMode(pTIMx, TIM_CHANNEL_1, TIM_IC_SELECTION_DIRECTTI);
+    TIM_SetICMode(pTIMx, TIM_CHANNEL_2, TIM_IC_SELECTION_DIRECTTI);
 
     //8. Configure polarities for CH1 and CH2
-    if (polarity == TIM_OC_POLARITY_LOW)
+    if (polarity == TIM_ENCODERINPUTPOLARITY_FALLING)
     {
-    	pTIMx->CCER |= TIM_CCER_CC1P_Pos;
-    	pTIMx->CCER |= TIM_CCER_CC2P_Pos;
+    	pTIMx->CCER |= (1 << TIM_CCER_CC1P_Pos) | (1 << TIM_CCER_CC2P_Pos);
     }else {
-    	pTIMx->CCER &= ~TIM_CCER_CC1P_Pos;
-    	pTIMx->CCER &= ~TIM_CCER_CC2P_Pos;
+    	pTIMx->CCER &= ~((1 << TIM_CCER_CC1P_Pos) | (1 << TIM_CCER_CC2P_Pos));
     }
 
     // 9. Enable capture for both channels
-    pTIMx->CCER |= (TIM_CCER_CC1E_Pos | TIM_CCER_CC2E_Pos);
+    pTIMx->CCER |= (1 << TIM_CCER_CC1E_Pos) | (1 << TIM_CCER_CC2E_Pos);
 
     // 10. Enable counter
     TIM_CounterControl(pTIMx, ENABLE);
@@ -196,6 +220,7 @@ void TIM_SetConfigPWM(TIM_RegDef_t *pTIMx,
 
     // 7. Set Output Compare mode (e.g., PWM1, PWM2, toggle, etc.)
     TIM_SetOCMode(pTIMx, Channel, OCMode);
+    TIM_MainOutputEnable(pTIMx);
 
     // 8. Generate an update event to load all the registers
     pTIMx->EGR |= TIM_EGR_UG;
@@ -203,106 +228,203 @@ void TIM_SetConfigPWM(TIM_RegDef_t *pTIMx,
 
 /**
  * @brief  Initializes the GPIO pin for the specified timer channel.
+ * @param  TIMx: Pointer to the TIM peripheral register structure.
  * @param  channel: Specifies the timer channel to configure the GPIO for.
  * @retval None
  */
-void GPIO_Init_TIM(uint8_t channel)
+void GPIO_Init_TIM(TIM_RegDef_t *TIMx, uint8_t channel)
 {
     GPIO_HandleTypeDef GPIO_InitStruct;
+    const TIM_PinMap_t *pMap = TIM_GetPinMap(TIMx);
+
+    if (pMap == NULL || channel > TIM_CHANNEL_4 || pMap->Pin[channel] == TIM_PIN_NONE)
+    {
+        // Timer without capture/compare pins or invalid channel
+        return;
+    }
 
-    GPIO_InitStruct.pGPIOx = GPIOA;
+    GPIO_InitStruct.pGPIOx = pMap->pGPIOx;
+    GPIO_InitStruct.Init.Pin = pMap->Pin[channel];
     GPIO_InitStruct.Init.Mode = GPIO_MODE_AF;
     GPIO_InitStruct.Init.OPType = GPIO_OPTYPE_PP;
     GPIO_InitStruct.Init.Pull = GPIO_NOPULL;
     GPIO_InitStruct.Init.Speed = GPIO_SPEED_LOW;
-    GPIO_InitStruct.Init.Alternate = 1; // TIM2 uses AF1 on PA0–PA3
+    GPIO_InitStruct.Init.Alternate = pMap->Alternate;
+    GPIO_Init(&GPIO_InitStruct);
+}
 
-    switch (channel)
-    {
-        case TIM_CHANNEL_1: // PA0
-            GPIO_InitStruct.Init.Pin = GPIO_PIN_0;
-            GPIO_Init(&GPIO_InitStruct);
-            break;
+/**
+ * @brief  Initializes GPIO pins for encoder interface (CH1 and CH2 of the timer).
+ * @param  TIMx: Pointer to the TIM peripheral register structure.
+ * @retval None
+ */
+void GPIO_Init_Encoder(TIM_RegDef_t *TIMx)
+{
+    GPIO_Init_TIM(TIMx, TIM_CHANNEL_1);
+    GPIO_Init_TIM(TIMx, TIM_CHANNEL_2);
+}
 
-        case TIM_CHANNEL_2: // PA1
-            GPIO_InitStruct.Init.Pin = GPIO_PIN_1;
-            GPIO_Init(&GPIO_InitStruct);
-            break;
+/**
+ * @brief  Initializes the timer for PWM mode on the specified channel.
+ * @param  htim: Pointer to the TIM handle, Init holds the time base used for the PWM.
+ * @param  channel: Specifies the timer channel to configure for PWM output.
+ * @retval None
+ */
+void TIM_PWM_Init(TIM_HandleTypeDef *htim, uint8_t channel)
+{
 
-        case TIM_CHANNEL_3: // PA2
-            GPIO_InitStruct.Init.Pin = GPIO_PIN_2;
-            GPIO_Init(&GPIO_InitStruct);
-            break;
+	 /* Enable clock for the TIM */
+	TIM_PeriClockControl(htim->pTIMx, ENABLE);
 
-        case TIM_CHANNEL_4: // PA3
-            GPIO_InitStruct.Init.Pin = GPIO_PIN_3;
-            GPIO_Init(&GPIO_InitStruct);
-            break;
+	/* GPIO Init for the TIM */
+	GPIO_Init_TIM(htim->pTIMx, channel);
 
-        default:
-            // Invalid channel
-            break;
-    }
+	/* Init the base time for the PWM, output starts at 0% duty */
+	TIM_SetConfigPWM(htim->pTIMx, htim->Init.CounterMode, channel, TIM_OC_POLARITY_HIGH,
+			 htim->Init.Prescaler, htim->Init.Period, 0, TIM_OCMODE_PWM1);
 }
 
 /**
- * @brief  Initializes GPIO pins for encoder interface.
- * @param  None
+ * @brief  Initializes the timer for encoder mode (TI1 and TI2, both edges counted).
+ * @param  htim: Pointer to the TIM handle, Init.Period is the counter wrap value.
  * @retval None
  */
-void GPIO_Init_Encoder(void)
+void TIM_Encoder_Init(TIM_HandleTypeDef *htim)
 {
-    GPIO_HandleTypeDef GPIO_InitStruct;
-
-    GPIO_InitStruct.pGPIOx = GPIOA;
-    GPIO_InitStruct.Init.Mode = GPIO_MODE_AF;
-    GPIO_InitStruct.Init.OPType = GPIO_OPTYPE_PP;
-    GPIO_InitStruct.Init.Pull = GPIO_NOPULL;
-    GPIO_InitStruct.Init.Speed = GPIO_SPEED_LOW;
-    GPIO_InitStruct.Init.Alternate = 1; // TIM2 uses AF1 on PA0–PA3
+	 /* Enable clock for the TIM */
+	TIM_PeriClockControl(htim->pTIMx, ENABLE);
 
-    GPIO_InitStruct.Init.Pin = GPIO_PIN_0;
-    GPIO_Init(&GPIO_InitStruct);
+	/* GPIO Init for the encoder */
+	GPIO_Init_Encoder(htim->pTIMx);
 
-    GPIO_InitStruct.Init.Pin = GPIO_PIN_1;
-    GPIO_Init(&GPIO_InitStruct);
+	/* Init the base time for the Encoder */
+	TIM_SetConfigEncoder(htim->pTIMx, htim->Init.CounterMode, TIM_ENCODERINPUTPOLARITY_RISING,
+			     htim->Init.Prescaler, htim->Init.Period, TIM_ENCODERMODE_TI12);
 }
 
 /**
- * @brief  Initializes the timer for PWM mode on the specified channel.
- * @param  TIMx: Pointer to the TIM peripheral register structure.
- * @param  channel: Specifies the timer channel to configure for PWM output.
+ * @brief  Initializes one timer channel in input capture mode (direct TIx input).
+ *         The counter runs from the time base in htim->Init, so the captured values are
+ *         timestamps in units of (Prescaler + 1) timer clocks.
+ * @param  htim: Pointer to the TIM handle.
+ * @param  channel: Specifies the timer channel to capture on.
+ * @param  polarity: TIM_ICPOLARITY_RISING, TIM_ICPOLARITY_FALLING or TIM_ICPOLARITY_BOTHEDGE.
  * @retval None
  */
-void TIM_PWM_Init(TIM_RegDef_t *TIMx,uint8_t channel)
+void TIM_IC_Init(TIM_HandleTypeDef *htim, uint8_t channel, uint8_t polarity)
 {
+	TIM_RegDef_t *TIMx = htim->pTIMx;
+	uint8_t shift = 4 * channel;
 
-	 /* Enable clock for the TIM */
+	/* Enable clock for the TIM */
 	TIM_PeriClockControl(TIMx, ENABLE);
 
-	/* GPIO Init for the TIM */
-	GPIO_Init_TIM(channel);
+	/* GPIO Init for the capture input */
+	GPIO_Init_TIM(TIMx, channel);
+
+	/* Time base */
+	TIM_SetCounterMode(TIMx, htim->Init.CounterMode);
+	TIMx->PSC = htim->Init.Prescaler;
+	TIMx->ARR = htim->Init.Period;
+
+	/* Capture channel mapped on its own TIx input, no filter, no prescaler */
+	TIM_SetICMode(TIMx, channel, TIM_IC_SELECTION_DIRECTTI);
+
+	/* CCxP/CCxNP select the active edge(s) */
+	TIMx->CCER &= ~((1 << (TIM_CCER_CC1P_Pos + shift)) | (1 << (TIM_CCER_CCxNP_Pos + shift)));
+	if (polarity == TIM_ICPOLARITY_FALLING)
+	{
+		TIMx->CCER |= (1 << (TIM_CCER_CC1P_Pos + shift));
+	}else if (polarity == TIM_ICPOLARITY_BOTHEDGE)
+	{
+		TIMx->CCER |= (1 << (TIM_CCER_CC1P_Pos + shift)) | (1 << (TIM_CCER_CCxNP_Pos + shift));
+	}
+
+	/* Enable capture */
+	TIMx->CCER |= (1 << (TIM_CCER_CC1E_Pos + shift));
 
-	/* Init the base time for the PWM */
-	TIM_SetConfigPWM(TIM2, TIM_COUNTERMODE_UP, TIM_CHANNEL_1, TIM_OC_POLARITY_HIGH, 15, 999, 500, TIM_OCMODE_PWM1);
+	/* Load the prescaler and start counting */
+	TIMx->EGR |= TIM_EGR_UG;
+	TIMx->SR = 0;
+	TIM_CounterControl(TIMx, ENABLE);
 }
 
 /**
- * @brief  Initializes the timer for encoder mode.
- * @param  TIMx: Pointer to the TIM peripheral register structure.
+ * @brief  Initializes one timer channel as a compare output and starts the counter.
+ *         With TIM_OCMODE_PWM1 the pin is high for the first Pulse ticks of every period,
+ *         which generates a periodic pulse without any CPU involvement.
+ * @param  htim: Pointer to the TIM handle, Init holds the time base.
+ * @param  channel: Specifies the timer channel to drive.
+ * @param  OCMode: Output compare mode (TIM_OCMODE_xxx).
+ * @param  Pulse: Compare value.
  * @retval None
  */
-void TIM_Encoder_Init(TIM_RegDef_t *TIMx)
+void TIM_OC_Init(TIM_HandleTypeDef *htim, uint8_t channel, uint8_t OCMode, uint32_t Pulse)
 {
-	 /* Enable clock for the TIM */
+	TIM_RegDef_t *TIMx = htim->pTIMx;
+
+	/* Enable clock for the TIM */
 	TIM_PeriClockControl(TIMx, ENABLE);
 
-	/* GPIO Init for the encoder */
-	GPIO_Init_Encoder();
+	/* GPIO Init for the compare output */
+	GPIO_Init_TIM(TIMx, channel);
 
-	/* Init the base time for the Encoder */
-	TIM_SetConfigEncoder(TIMx, TIM_COUNTERMODE_UP, TIM_OC_POLARITY_LOW, 0, 0xFFFF, TIM_ENCODERMODE_TI12);
+	/* Time base and compare value */
+	TIM_SetCounterMode(TIMx, htim->Init.CounterMode);
+	TIM_ConfigTimeBase(TIMx, htim->Init.Prescaler, htim->Init.Period, Pulse, channel);
+
+	/* Output mode, compare value applied at the update event */
+	TIM_SetOCMode(TIMx, channel, OCMode);
+	TIM_SetOCPreload(TIMx, channel, ENABLE);
+	TIM_SetChannelPolarity(TIMx, channel, TIM_OC_POLARITY_HIGH);
+	TIM_ChannelOutputControl(TIMx, channel, ENABLE);
+	TIM_MainOutputEnable(TIMx);
+
+	/* Load the registers and start counting */
+	TIMx->EGR |= TIM_EGR_UG;
+	TIMx->SR = 0;
+	TIM_CounterControl(TIMx, ENABLE);
 }
+
+/**
+  * @brief  Enables or disables timer interrupt sources.
+  * @param  TIMx    Pointer to TIM peripheral (e.g., TIM2).
+  * @param  ITMask  Combination of TIM_DIER_xxx bits.
+  * @param  State   ENABLE or DISABLE.
+  * @retval None
+  */
+void TIM_ITConfig(TIM_RegDef_t *TIMx, uint32_t ITMask, uint8_t State)
+{
+	if (State == ENABLE)
+	{
+		TIMx->DIER |= ITMask;
+	}else {
+		TIMx->DIER &= ~ITMask;
+	}
+}
+
+/**
+  * @brief  Enables or disables a timer IRQ in the NVIC.
+  * @param  IRQNumber Specifies the IRQ number (e.g., IRQ_NO_TIM3).
+  * @param  state ENABLE or DISABLE.
+  * @retval None
+  */
+void TIM_IRQInterruptConfig(uint8_t IRQNumber, uint8_t state)
+{
+	NVIC_IRQInterruptConfig(IRQNumber, state);
+}
+
+/**
+  * @brief  Configures the priority of a timer IRQ.
+  * @param  IRQNumber Specifies the IRQ number.
+  * @param  IRQPriority Specifies the priority level (0-15, lower is higher priority).
+  * @retval None
+  */
+void TIM_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority)
+{
+	NVIC_IRQPriorityConfig(IRQNumber, (uint8_t)IRQPriority);
+}
+
 /**
   * @brief  Configures the output polarity for the selected TIM channel.
   * @param  TIMx     Pointer to TIM peripheral (e.g., TIM2, TIM3,...).
@@ -312,48 +434,18 @@ void TIM_Encoder_Init(TIM_RegDef_t *TIMx)
   */
 void TIM_SetChannelPolarity(TIM_RegDef_t *TIMx, uint8_t channel, uint8_t polarity)
 {
-  switch(channel)
+  if (channel > TIM_CHANNEL_4)
   {
-    case TIM_CHANNEL_1:
-	    if (polarity == TIM_OC_POLARITY_LOW)
-	    {
-		    TIMx->CR1 |= (1 << TIM_CCER_CC1P_Pos);
-	    }else {
-		    TIMx->CR1 &= ~(1 << TIM_CCER_CC1P_Pos);
-	    }
-	    break;
-
-    case TIM_CHANNEL_2:
-	    if (polarity == TIM_OC_POLARITY_LOW)
-	    {
-		    TIMx->CR1 |= (1 << TIM_CCER_CC2P_Pos);
-	    }else {
-		    TIMx->CR1 &= ~(1 << TIM_CCER_CC2P_Pos);
-	    }
-	    break;
-
-    case TIM_CHANNEL_3:
-	    if (polarity == TIM_OC_POLARITY_LOW)
-	    {
-		    TIMx->CR1 |= (1 << TIM_CCER_CC3P_Pos);
-	    }else {
-		    TIMx->CR1 &= ~(1 << TIM_CCER_CC3P_Pos);
-	    }
-	    break;
-
-    case TIM_CHANNEL_4:
-	    if (polarity == TIM_OC_POLARITY_LOW)
-	    {
-		    TIMx->CR1 |= (1 << TIM_CCER_CC4P_Pos);
-	    }else {
-		    TIMx->CR1 &= ~(1 << TIM_CCER_CC4P_Pos);
-	    }
-	    break;
-
-    default:
-	    /* Nothing to do */
-	    break;
+	  /* Nothing to do */
+	  return;
+  }
 
+  // CCxP sits at bit 1 of each 4-bit channel field of CCER
+  if (polarity == TIM_OC_POLARITY_LOW)
+  {
+	  TIMx->CCER |= (1 << (TIM_CCER_CC1P_Pos + 4 * channel));
+  }else {
+	  TIMx->CCER &= ~(1 << (TIM_CCER_CC1P_Pos + 4 * channel));
   }
 }
 
@@ -419,45 +511,124 @@ void TIM_ConfigTimeBase(TIM_RegDef_t *TIMx, uint32_t Prescaler, uint32_t Period,
     // Set auto-reload (period)
     TIMx->ARR = Period;
 
-    // Set duty cycle based on channel
-    switch(Channel)
+    // Set duty cycle of the channel
+    if (Channel <= TIM_CHANNEL_4)
     {
-      case TIM_CHANNEL_1:
-	  TIMx->CCR1 = DutyCycle;
-	  break;
-
-      case TIM_CHANNEL_2:
-	  TIMx->CCR2 = DutyCycle;
-	  break;
+        (&TIMx->CCR1)[Channel] = DutyCycle;
+    }
+}
 
-      case TIM_CHANNEL_3:
-	  TIMx->CCR3 = DutyCycle;
-	  break;
 
-      case TIM_CHANNEL_4:
-	  TIMx->CCR4 = DutyCycle;
-	  break;
+/**
+  * @brief  Returns the counter clock of a timer (before the prescaler).
+  * @note   When the APB prescaler is not 1, the timer clock is twice the APB clock.
+  * @param  TIMx  Pointer to TIM peripheral (e.g., TIM2).
+  * @retval Timer input clock in Hz.
+  */
+uint32_t TIM_GetClockFreq(TIM_RegDef_t *TIMx)
+{
+    uint32_t pclk;
+    uint8_t apbDivided;
 
-      default:
-	  // Invalid channel
-	  break;
+    if (TIMx == TIM1 || TIMx == TIM8 || TIMx == TIM9 || TIMx == TIM10 || TIMx == TIM11)
+    {
+        pclk = RCC_GetPCLK2_Value();
+        apbDivided = ((RCC->CFGR >> 13) & 0x7) >= 4;   // PPRE2
+    }
+    else
+    {
+        pclk = RCC_GetPCLK1_Value();
+        apbDivided = ((RCC->CFGR >> 10) & 0x7) >= 4;   // PPRE1
     }
-}
 
+    return apbDivided ? (2 * pclk) : pclk;
+}
 
-void TIM_SetDuty(uint32_t DutyCycle)
+/**
+  * @brief  Programs the PWM frequency of a timer with the finest duty resolution available.
+  *
+  * The prescaler is kept as small as possible so that ARR gets as many counts as fit in
+  * 16 bits. Auto-reload preload (ARPE) is enabled so that period changes are glitch-free;
+  * channels should also enable OCxPE (TIM_SetOCPreload) for their compare values.
+  *
+  * @param  htim         Pointer to the TIM handle, Init.Prescaler/Period are updated.
+  * @param  FrequencyHz  Requested PWM frequency in Hz (e.g., 20000).
+  * @retval Number of timer counts per PWM period (ARR + 1), i.e. the 100% duty compare value.
+  *         Returns 0 if the frequency cannot be generated.
+  */
+uint32_t TIM_PWM_SetFrequency(TIM_HandleTypeDef *htim, uint32_t FrequencyHz)
 {
-       TIM2->CCR1 = DutyCycle;
-}
+    TIM_RegDef_t *TIMx = htim->pTIMx;
+    uint32_t ticks, prescaler, period;
+
+    if (FrequencyHz == 0)
+    {
+        return 0;
+    }
+
+    ticks = TIM_GetClockFreq(TIMx) / FrequencyHz;
+    if (ticks < 2)
+    {
+        return 0;
+    }
+
+    // Smallest prescaler that keeps the period within 16 bits
+    prescaler = (ticks - 1) / (TIM_ARR_MAX_16BIT + 1);
+    period = ticks / (prescaler + 1);
 
+    TIMx->CR1 |= TIM_CR1_ARPE;
+    TIMx->PSC = prescaler;
+    TIMx->ARR = period - 1;
 
+    // Load PSC/ARR immediately instead of waiting for the current period to end
+    TIMx->EGR |= TIM_EGR_UG;
 
-uint16_t TIM_GetCounter(void)
+    htim->Init.Prescaler = prescaler;
+    htim->Init.Period = period - 1;
+
+    return period;
+}
+
+/**
+  * @brief  Updates the compare values of two channels of the same timer so that
+  *         both take effect on the same update event.
+  * @note   The channels must have output compare preload enabled (see TIM_SetOCPreload).
+  *         UDIS holds off the preload transfer while the two registers are written.
+  * @param  htim      Pointer to the TIM handle.
+  * @param  ChannelA  First channel to update.
+  * @param  ValueA    New Capture/Compare value of the first channel.
+  * @param  ChannelB  Second channel to update.
+  * @param  ValueB    New Capture/Compare value of the second channel.
+  * @retval None
+  */
+void TIM_SetDualCompare(TIM_HandleTypeDef *htim, uint8_t ChannelA, uint32_t ValueA, uint8_t ChannelB, uint32_t ValueB)
 {
-       uint16_t value = TIM2->CNT;
-       return value;
+    htim->pTIMx->CR1 |= TIM_CR1_UDIS;
+    TIM_SetCompare(htim, ChannelA, ValueA);
+    TIM_SetCompare(htim, ChannelB, ValueB);
+    htim->pTIMx->CR1 &= ~TIM_CR1_UDIS;
 }
 
+/**
+  * @brief  Enables or disables the output compare preload (OCxPE) of a channel.
+  *         With preload enabled, a new compare value is only applied at the next update event.
+  * @param  TIMx     Pointer to TIM peripheral (e.g., TIM2).
+  * @param  channel  Specifies the TIM channel (TIM_CHANNEL_1 to TIM_CHANNEL_4).
+  * @param  State    ENABLE or DISABLE.
+  * @retval None
+  */
+void TIM_SetOCPreload(TIM_RegDef_t *TIMx, uint8_t channel, uint8_t State)
+{
+    __vo uint32_t *pCCMR = (channel <= TIM_CHANNEL_2) ? &TIMx->CCMR1 : &TIMx->CCMR2;
+    uint8_t pos = (channel == TIM_CHANNEL_1 || channel == TIM_CHANNEL_3) ? TIM_CCMR1_OC1PE_Pos : TIM_CCMR1_OC2PE_Pos;
+
+    if (State == ENABLE)
+        *pCCMR |= (1 << pos);
+    else
+        *pCCMR &= ~(1 << pos);
+}
+
+
 /**
   * @brief  Selects the Output Compare Mode for TIM Channels 1 to 4.
   * @param  TIMx     Pointer to TIM peripheral (e.g., TIM2).
@@ -593,3 +764,35 @@ static void TIM_CounterControl(TIM_RegDef_t *pTIMx, uint8_t State)
 		pTIMx->CR1 &= ~TIM_CR1_CEN;
 	}
 }
+
+/**
+  * @brief  Enables the outputs of an advanced timer (TIM1/TIM8): their OCx pins stay
+  *         off until MOE is set, whatever CCxE says. No-op on the other timers.
+  *         OSSR/OSSI stay 0, only the OCx outputs are used (no complementary outputs).
+  * @param  TIMx TIM peripheral
+  * @retval None
+  */
+static void TIM_MainOutputEnable(TIM_RegDef_t *TIMx)
+{
+	if (TIMx == TIM1 || TIMx == TIM8)
+	{
+		TIMx->BDTR |= TIM_BDTR_MOE;
+	}
+}
+
+/**
+  * @brief  Looks up the capture/compare pin mapping of a timer.
+  * @param  TIMx TIM peripheral
+  * @retval Pointer to the mapping entry, NULL if the timer has no entry
+  */
+static const TIM_PinMap_t *TIM_GetPinMap(TIM_RegDef_t *TIMx)
+{
+	for (uint8_t i = 0; i < sizeof(TIM_PinMap) / sizeof(TIM_PinMap[0]); i++)
+	{
+		if (TIM_PinMap[i].pTIMx == TIMx)
+		{
+			return &TIM_PinMap[i];
+		}
+	}
+	return NULL;
+}
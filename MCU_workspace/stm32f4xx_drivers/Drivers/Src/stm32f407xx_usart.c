@@ -11,6 +11,10 @@
 static void USART_EndTxTransfer(USART_HandleTypeDef *husart);
 static void USART_Transmit_TXE(USART_HandleTypeDef *husart);
 static void USART_Receive_RXNE(USART_HandleTypeDef *husart);
+static void USART_DMATxCplt(DMA_HandleTypeDef *hdma);
+static void USART_DMATxError(DMA_HandleTypeDef *hdma);
+static void USART_DMARxHalfCplt(DMA_HandleTypeDef *hdma);
+static void USART_DMARxCplt(DMA_HandleTypeDef *hdma);
 
 
 
@@ -536,15 +540,139 @@ uint8_t USART_Receive_IT(USART_HandleTypeDef *husart, uint8_t *pRxBuffer, uint32
   return state;  // Return the previous state of the USART reception
 }
 
+/**
+  * @brief  Sends a buffer with DMA, the CPU is not involved until the transfer completes.
+  * @note   husart->hdmatx must be initialized (DMA_MEMORY_TO_PERIPH, byte data,
+  *         memory increment, DMA_NORMAL). Completion is reported with
+  *         USART_EVENT_TX_CMPLT once the last byte is written to DR.
+  * @param  husart Pointer to a USART_HandleTypeDef structure.
+  * @param  pTxBuffer Pointer to the data, must stay valid until completion.
+  * @param  Len Number of bytes to send.
+  * @retval State of the transmission before the call, USART_STATE_READY if it was started.
+  */
+uint8_t USART_Transmit_DMA(USART_HandleTypeDef *husart, uint8_t *pTxBuffer, uint16_t Len)
+{
+  uint8_t state = husart->TxState;
+
+  if (state == USART_STATE_READY && husart->hdmatx != NULL && Len > 0)
+  {
+    husart->pTxBuffer = pTxBuffer;
+    husart->TxLen = Len;
+    husart->TxState = USART_STATE_BUSY_TX;
+
+    husart->hdmatx->Parent = husart;
+    husart->hdmatx->XferCpltCallback = USART_DMATxCplt;
+    husart->hdmatx->XferHalfCpltCallback = NULL;
+    husart->hdmatx->XferErrorCallback = USART_DMATxError;
+
+    if (DMA_Start_IT(husart->hdmatx, (uint32_t)(uintptr_t)pTxBuffer, (uint32_t)(uintptr_t)&husart->pUSARTx->DR, Len) != DMA_OK)
+    {
+      husart->TxState = USART_STATE_READY;
+      return USART_STATE_BUSY_TX;
+    }
+
+    // TXE requests start the stream as soon as DMAT is set
+    husart->pUSARTx->CR3 |= (1 << USART_CR3_DMAT);
+  }
+
+  return state;
+}
+
+/**
+  * @brief  Starts a circular DMA reception that reports the received data on IDLE line,
+  *         half buffer and full buffer events through husart->RxEventCallback.
+  * @note   husart->hdmarx must be initialized (DMA_PERIPH_TO_MEMORY, byte data,
+  *         memory increment, DMA_CIRCULAR) and the USART IRQ enabled by the caller.
+  *         The reception runs until USART_AbortReceive_DMA, no byte is handled by the CPU.
+  * @param  husart Pointer to a USART_HandleTypeDef structure.
+  * @param  pRxBuffer Pointer to the ring buffer.
+  * @param  Len Size of the ring buffer in bytes.
+  * @retval State of the reception before the call.
+  */
+uint8_t USART_ReceiveToIdle_DMA(USART_HandleTypeDef *husart, uint8_t *pRxBuffer, uint16_t Len)
+{
+  uint8_t state = husart->RxState;
+
+  if (state == USART_STATE_READY && husart->hdmarx != NULL && Len > 0)
+  {
+    husart->pRxBuffer = pRxBuffer;
+    husart->RxLen = Len;
+    husart->RxState = USART_STATE_BUSY_RX_DMA;
+
+    husart->hdmarx->Parent = husart;
+    husart->hdmarx->XferHalfCpltCallback = USART_DMARxHalfCplt;
+    husart->hdmarx->XferCpltCallback = USART_DMARxCplt;
+
+    if (DMA_Start_IT(husart->hdmarx, (uint32_t)(uintptr_t)&husart->pUSARTx->DR, (uint32_t)(uintptr_t)pRxBuffer, Len) != DMA_OK)
+    {
+      husart->RxState = USART_STATE_READY;
+      return state;
+    }
+
+    // Clear a pending IDLE/ORE left from before the start (SR read followed by DR read)
+    USART_ClearFlag(husart->pUSARTx, USART_FLAG_IDLE);
+
+    husart->pUSARTx->CR3 |= (1 << USART_CR3_DMAR);
+    husart->pUSARTx->CR1 |= (1 << USART_CR1_IDLEIE);
+  }
+
+  return state;
+}
+
+/**
+  * @brief  Stops a reception started with USART_ReceiveToIdle_DMA.
+  * @param  husart Pointer to a USART_HandleTypeDef structure.
+  * @retval None
+  */
+void USART_AbortReceive_DMA(USART_HandleTypeDef *husart)
+{
+  if (husart->RxState != USART_STATE_BUSY_RX_DMA)
+  {
+    return;
+  }
+
+  husart->pUSARTx->CR1 &= ~(1 << USART_CR1_IDLEIE);
+  husart->pUSARTx->CR3 &= ~(1 << USART_CR3_DMAR);
+  DMA_Abort(husart->hdmarx);
+
+  husart->RxState = USART_STATE_READY;
+}
+
+/**
+  * @brief  Returns the next position the DMA will write in the reception buffer.
+  * @note   Everything before this position (modulo the buffer size) has been received.
+  * @param  husart Pointer to a USART_HandleTypeDef structure.
+  * @retval Write position (0..RxLen-1).
+  */
+uint16_t USART_GetRxDMAPosition(USART_HandleTypeDef *husart)
+{
+  uint16_t pos = (uint16_t)(husart->RxLen - DMA_GetCounter(husart->hdmarx));
+
+  // NDTR reloads to RxLen on wrap, which reads as position RxLen for a moment
+  return (pos >= husart->RxLen) ? 0 : pos;
+}
+
 /**
   * @brief  Clear the status of a specific flag in the USART Status Register (SR).
+  * @note   PE, FE, NE, ORE and IDLE are not cleared by writing SR, they are cleared by
+  *         a read of SR followed by a read of DR.
   * @param  pUSARTx Pointer to the USART peripheral (USART1, USART2, USART3 and UART4).
   * @param  FlagName The flag to check
   * @retval None
   */
 void USART_ClearFlag(USART_RegDef_t *pUSARTx, uint16_t FlagName)
 {
-	pUSARTx->SR &= ~(FlagName);
+	if (FlagName & (USART_FLAG_PE | USART_FLAG_FE | USART_FLAG_NE | USART_FLAG_ORE | USART_FLAG_IDLE))
+	{
+		(void)pUSARTx->SR;
+		(void)pUSARTx->DR;
+	}
+
+	FlagName &= ~(USART_FLAG_PE | USART_FLAG_FE | USART_FLAG_NE | USART_FLAG_ORE | USART_FLAG_IDLE);
+	if (FlagName)
+	{
+		pUSARTx->SR &= ~(FlagName);
+	}
 }
 
 /**
@@ -555,58 +683,18 @@ void USART_ClearFlag(USART_RegDef_t *pUSARTx, uint16_t FlagName)
   */
 void USART_IRQInterruptConfig(uint8_t IRQNumber, uint8_t state)
 {
-
-    if(state == ENABLE)
-    {
-        if(IRQNumber <= 31)
-        {
-            //program ISER0 register
-            *NVIC_ISER0 |= ( 1 << IRQNumber );
-
-        }else if(IRQNumber > 31 && IRQNumber < 64 ) //32 to 63
-        {
-            //program ISER1 register
-            *NVIC_ISER1 |= ( 1 << (IRQNumber % 32) );
-        }
-        else if(IRQNumber >= 64 && IRQNumber < 96 )
-        {
-            //program ISER2 register //64 to 95
-            *NVIC_ISER3 |= ( 1 << (IRQNumber % 64) );
-        }
-    }else
-    {
-        if(IRQNumber <= 31)
-        {
-            //program ICER0 register
-            *NVIC_ICER0 |= ( 1 << IRQNumber );
-        }else if(IRQNumber > 31 && IRQNumber < 64 )
-        {
-            //program ICER1 register
-            *NVIC_ICER1 |= ( 1 << (IRQNumber % 32) );
-        }
-        else if(IRQNumber >= 6 && IRQNumber < 96 )
-        {
-            //program ICER2 register
-            *NVIC_ICER3 |= ( 1 << (IRQNumber % 64) );
-        }
-    }
+	NVIC_IRQInterruptConfig(IRQNumber, state);
 }
 
 /**
   * @brief  Configures the priority of an IRQ.
   * @param  IRQNumber Specifies the IRQ number.
-  * @param  IRQPriority Specifies the priority level (0-255, lower is higher priority).
+  * @param  IRQPriority Specifies the priority level (0-15, lower is higher priority), see @ref IRQ_Priority_Plan.
   * @retval None
   */
 void USART_IRQPriorityConfig(uint8_t IRQNumber, uint32_t IRQPriority)
 {
-    //1. first lets find out the ipr register
-    uint8_t iprx = IRQNumber / 4;
-    uint8_t iprx_section  = IRQNumber %4 ;
-
-    uint8_t shift_amount = ( 8 * iprx_section) + ( 8 - NO_PR_BITS_IMPLEMENTED) ;
-
-    *(  NVIC_PR_BASEADDR + iprx ) |=  ( IRQPriority << shift_amount );
+	NVIC_IRQPriorityConfig(IRQNumber, (uint8_t)IRQPriority);
 }
 
 /**
@@ -855,20 +943,27 @@ void USART_IRQHandler(USART_HandleTypeDef *husart)
 
   if(temp1 && temp2)
   {
-    //Implement the code to clear the IDLE flag. Refer to the RM to understand the clear sequence
-    temp1 = husart->pUSARTx->SR &= ~( 1 << USART_SR_IDLE);
+    //Clear the IDLE flag: SR has just been read, a read of DR completes the sequence
+    (void)husart->pUSARTx->DR;
 
     //this interrupt is because of idle
-    USART_ApplicationEventCallback(husart,USART_EVENT_IDLE);
+    if(husart->RxState == USART_STATE_BUSY_RX_DMA && husart->RxEventCallback != NULL)
+    {
+      husart->RxEventCallback(husart, USART_GetRxDMAPosition(husart));
+    }
+    else
+    {
+      USART_ApplicationEventCallback(husart,USART_EVENT_IDLE);
+    }
   }
 
 /*************************Check for Overrun detection flag ********************************************/
 
   //Implement the code to check the status of ORE flag  in the SR
-  temp1 = husart->pUSARTx->SR & USART_SR_ORE;
+  temp1 = husart->pUSARTx->SR & ( 1 << USART_SR_ORE);
 
   //Implement the code to check the status of RXNEIE  bit in the CR1
-  temp2 = husart->pUSARTx->CR1 & USART_CR1_RXNEIE;
+  temp2 = husart->pUSARTx->CR1 & ( 1 << USART_CR1_RXNEIE);
 
 
   if(temp1  && temp2 )
@@ -917,6 +1012,60 @@ void USART_IRQHandler(USART_HandleTypeDef *husart)
   }
 }
 
+/**
+  * @brief  DMA transfer complete of USART_Transmit_DMA, the last byte is in the shift register.
+  */
+static void USART_DMATxCplt(DMA_HandleTypeDef *hdma)
+{
+  USART_HandleTypeDef *husart = (USART_HandleTypeDef *)hdma->Parent;
+
+  husart->pUSARTx->CR3 &= ~(1 << USART_CR3_DMAT);
+  husart->TxLen = 0;
+  husart->TxState = USART_STATE_READY;
+
+  USART_ApplicationEventCallback(husart, USART_EVENT_TX_CMPLT);
+}
+
+/**
+  * @brief  DMA transfer error of USART_Transmit_DMA.
+  */
+static void USART_DMATxError(DMA_HandleTypeDef *hdma)
+{
+  USART_HandleTypeDef *husart = (USART_HandleTypeDef *)hdma->Parent;
+
+  husart->pUSARTx->CR3 &= ~(1 << USART_CR3_DMAT);
+  husart->TxLen = 0;
+  husart->TxState = USART_STATE_READY;
+
+  USART_ApplicationEventCallback(husart, USART_EVENT_DMA_ERROR);
+}
+
+/**
+  * @brief  Half buffer reached during a receive to idle DMA reception.
+  */
+static void USART_DMARxHalfCplt(DMA_HandleTypeDef *hdma)
+{
+  USART_HandleTypeDef *husart = (USART_HandleTypeDef *)hdma->Parent;
+
+  if (husart->RxEventCallback != NULL)
+  {
+    husart->RxEventCallback(husart, (uint16_t)(husart->RxLen / 2));
+  }
+}
+
+/**
+  * @brief  End of buffer reached during a receive to idle DMA reception, the stream wraps to 0.
+  */
+static void USART_DMARxCplt(DMA_HandleTypeDef *hdma)
+{
+  USART_HandleTypeDef *husart = (USART_HandleTypeDef *)hdma->Parent;
+
+  if (husart->RxEventCallback != NULL)
+  {
+    husart->RxEventCallback(husart, 0);
+  }
+}
+
 __weak void USART_ApplicationEventCallback(USART_HandleTypeDef *husart,uint8_t event)
 {
 
@@ -0,0 +1,38 @@
+/*
+ * BalanceTrim.h
+ *
+ *  Created on: Jul 16, 2025
+ *      Author: quanvm198
+ */
+
+#ifndef INC_BALANCETRIM_H_
+#define INC_BALANCETRIM_H_
+
+#include "stm32f407xx.h"
+
+/*
+ * Online estimate of the balance point. Held away from its true equilibrium the robot
+ * needs a steady motor effort and creeps in the direction it leans, so the setpoint is
+ * moved slowly against the filtered effort and wheel speed. It is kept within
+ * +/-BALANCETRIM_LIMIT_DEG, moves at most BALANCETRIM_MAX_RATE_DPS, and is saved to the
+ * parameter store now and then.
+ *
+ * Sign convention: a positive balance output drives the wheels forward (positive speed)
+ * to catch a negative angle. Set BALANCETRIM_SIGN to -1 if the robot is built the other way.
+ */
+#define BALANCETRIM_SIGN				1
+#define BALANCETRIM_FILTER_TAU_S		2.0f		//Effort and speed averaging
+#define BALANCETRIM_GAIN_EFFORT			0.0005f		//deg/s per PWM count of mean effort
+#define BALANCETRIM_GAIN_SPEED			0.1f		//deg/s per rad/s of mean wheel speed
+#define BALANCETRIM_MAX_RATE_DPS		0.2f
+#define BALANCETRIM_LIMIT_DEG			8.0f
+#define BALANCETRIM_ACTIVE_DEG			10.0f		//Adapt only this close to the setpoint (not fallen)
+#define BALANCETRIM_SAVE_PERIOD_MS		60000
+#define BALANCETRIM_SAVE_DELTA_DEG		0.05f		//Smaller changes are not worth a record
+
+
+void BalanceTrim_Init(void);
+void BalanceTrim_Update(double Angle, double Output, float WheelSpeed, float Dt);
+double BalanceTrim_Get(void);
+
+#endif /* INC_BALANCETRIM_H_ */
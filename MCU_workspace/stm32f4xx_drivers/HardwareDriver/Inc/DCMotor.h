@@ -14,13 +14,38 @@
 
 /*
  * L298N GPIO Pin
+ * IN1..IN4 share one port so that both bridges change direction in a single BSRR store.
  */
-#define	L298N_IN1_PORT		GPIOC
+#define	L298N_IN_PORT		GPIOC
+
+#define	L298N_IN1_PORT		L298N_IN_PORT
 #define	L298N_IN1_PIN		GPIO_PIN_2
 
-#define	L298N_IN2_PORT		GPIOC
+#define	L298N_IN2_PORT		L298N_IN_PORT
 #define	L298N_IN2_PIN		GPIO_PIN_3
 
+#define	L298N_IN3_PORT		L298N_IN_PORT
+#define	L298N_IN3_PIN		GPIO_PIN_4
+
+#define	L298N_IN4_PORT		L298N_IN_PORT
+#define	L298N_IN4_PIN		GPIO_PIN_5
+
+
+/*
+ * L298N PWM source: both enable inputs are driven by the same timer so that
+ * their compare registers are reloaded on the same update event.
+ */
+#define MOTOR_PWM_TIM			TIM2
+#define MOTOR_LEFT_PWM_CHANNEL		TIM_CHANNEL_1	//PA0 -> ENA
+#define MOTOR_RIGHT_PWM_CHANNEL		TIM_CHANNEL_2	//PA1 -> ENB
+
+#define MOTOR_PWM_FREQUENCY_HZ		20000	//Above the audible range
+
+/*
+ * Motor commands are expressed in +/-PWM_MAX and scaled to the real timer period.
+ */
+#define PWM_MAX 999
+
 
 /*
  * Define motor name
@@ -41,9 +66,11 @@
  * User function
  */
 void Motor_ConfigIN_GPIO(void);
-void Motor_ConfigDirection(_Bool Motor, _Bool Direction);
+void Motor_ConfigDirection(_Bool Motor, uint8_t Direction);
 void Motor_ConfigPWMSource(void);
 void Motor_Init(void);
 void Motor_Control(_Bool Motor, int16_t ControlSignal);
+void Motor_SetOutputs(int16_t LeftSignal, int16_t RightSignal);
+void Motor_Mix(int16_t Balance, int16_t Steering);
 
 #endif /* INC_DCMOTOR_H_ */
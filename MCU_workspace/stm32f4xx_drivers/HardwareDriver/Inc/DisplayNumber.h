@@ -0,0 +1,43 @@
+/*
+ * DisplayNumber.h
+ *
+ *  Created on: Jul 12, 2025
+ *      Author: quanvm198
+ */
+
+#ifndef INC_DISPLAYNUMBER_H_
+#define INC_DISPLAYNUMBER_H_
+
+#include "stm32f407xx.h"
+#include "MAX7219.h"
+
+/*
+ * Number formatting for the MAX7219 framebuffer, integer only.
+ *
+ * A field is Width digits starting at digit register Position (least significant digit)
+ * and growing towards the higher registers. Fixed point values are passed scaled, e.g. an
+ * angle of 12.3 deg with DecimalPlaces = 1 is the value 123.
+ */
+
+#define DISPLAYNUMBER_MAX_WIDTH			MAX7219_DIGIT_COUNT
+
+/*
+ * Format flags
+ */
+#define DISPLAYNUMBER_FLAG_NONE			0x00
+#define DISPLAYNUMBER_FLAG_ZERO_PAD		0x01	//Leading zeros instead of blanks
+#define DISPLAYNUMBER_FLAG_SEGMENTS		0x02	//Raw segment patterns, for digits without Code B decode
+
+/*
+ * Code B font (decode mode), bit 7 is the decimal point in both modes
+ */
+#define DISPLAYNUMBER_CODEB_MINUS		0x0A
+#define DISPLAYNUMBER_CODEB_BLANK		0x0F
+#define DISPLAYNUMBER_DP				0x80
+
+
+uint8_t DisplayNumber_Format(int32_t Value, uint8_t DecimalPlaces, uint8_t Width, uint8_t Flags, uint8_t *pCodes);
+uint8_t DisplayNumber_Show(uint8_t Position, uint8_t Width, int32_t Value, uint8_t DecimalPlaces, uint8_t Flags);
+void DisplayNumber_Blank(uint8_t Position, uint8_t Width, uint8_t Flags);
+
+#endif /* INC_DISPLAYNUMBER_H_ */
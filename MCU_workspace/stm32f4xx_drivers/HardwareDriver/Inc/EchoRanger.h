@@ -0,0 +1,52 @@
+/*
+ * EchoRanger.h
+ *
+ *  Created on: Jul 10, 2025
+ *      Author: quanvm198
+ */
+
+#ifndef INC_ECHORANGER_H_
+#define INC_ECHORANGER_H_
+
+#include "stm32f407xx.h"
+
+
+/*
+ * Trigger/echo ultrasonic module (HC-SR04 type) on one timer:
+ * the compare output times the trigger pulse, the capture input timestamps
+ * both edges of the echo pulse. Each EchoRanger_Trigger() starts one
+ * measurement window of ECHORANGER_CYCLE_MS.
+ */
+#define ECHORANGER_TIM				TIM5
+#define ECHORANGER_TRIG_CHANNEL		TIM_CHANNEL_3	//PA2 -> TRIG
+#define ECHORANGER_ECHO_CHANNEL		TIM_CHANNEL_4	//PA3 <- ECHO
+#define ECHORANGER_IRQ				IRQ_NO_TIM5
+#define ECHORANGER_IRQ_PRIORITY		IRQ_PRIO_RANGING
+
+#define ECHORANGER_CLOCK_HZ			1000000		//1 us capture resolution
+#define ECHORANGER_CYCLE_MS			60			//Measurement window: HC-SR04 minimum cycle, same as RANGING_SLOT_MS
+#define ECHORANGER_TRIG_US			10			//Trigger pulse width
+
+/*
+ * Measuring range in mm, echoes outside it are reported as out of range
+ */
+#define ECHORANGER_DISTANCE_MIN		20
+#define ECHORANGER_DISTANCE_MAX		4000
+
+
+/*
+ * Result of the last measurement cycle
+ */
+#define ECHORANGER_STATUS_NONE			0	//No measurement yet
+#define ECHORANGER_STATUS_VALID			1
+#define ECHORANGER_STATUS_OUT_OF_RANGE	2	//No echo in the cycle, or distance outside the range
+
+
+void EchoRanger_Init(void);
+void EchoRanger_Trigger(void);
+uint8_t EchoRanger_IsBusy(void);
+uint16_t EchoRanger_GetDistance(void);
+uint32_t EchoRanger_GetTimestamp(void);
+uint8_t EchoRanger_GetStatus(void);
+
+#endif /* INC_ECHORANGER_H_ */
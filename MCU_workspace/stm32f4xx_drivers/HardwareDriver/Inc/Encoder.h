@@ -0,0 +1,103 @@
+/*
+ * Encoder.h
+ *
+ *  Created on: Jul 2, 2025
+ *      Author: quanvm198
+ */
+
+#ifndef INC_ENCODER_H_
+#define INC_ENCODER_H_
+
+#include "stm32f407xx.h"
+
+
+/*
+ * Quadrature counters (M method): one timer per wheel in encoder mode TI1+TI2
+ */
+#define ENCODER_LEFT_TIM		TIM3	//PB4 -> A, PB5 -> B
+#define ENCODER_RIGHT_TIM		TIM4	//PD12 -> A, PD13 -> B
+
+/*
+ * Period measurement (T method): phase A of each wheel is also wired to a capture input
+ */
+#define ENCODER_CAPTURE_TIM			TIM9	//PE5 -> left A, PE6 -> right A
+#define ENCODER_LEFT_CAPTURE_CHANNEL	TIM_CHANNEL_1
+#define ENCODER_RIGHT_CAPTURE_CHANNEL	TIM_CHANNEL_2
+#define ENCODER_CAPTURE_IRQ			IRQ_NO_TIM1_BRK_TIM9
+#define ENCODER_CAPTURE_IRQ_PRIORITY	IRQ_PRIO_ENCODER
+#define ENCODER_CAPTURE_CLOCK_HZ	1000000	//1 us timestamp resolution
+
+
+/*
+ * Wheel and encoder geometry
+ */
+#define ENCODER_LINES_PER_REV		330		//Phase A rising edges per wheel revolution (11 PPR x 30:1)
+#define ENCODER_COUNTS_PER_REV		(4 * ENCODER_LINES_PER_REV)	//Quadrature counts per revolution
+#define ENCODER_WHEEL_RADIUS_M		0.0325f
+
+/*
+ * Counting direction of each wheel, the right motor is mounted mirrored
+ */
+#define ENCODER_LEFT_SIGN		1
+#define ENCODER_RIGHT_SIGN		(-1)
+
+
+/*
+ * Estimator settings
+ */
+#define ENCODER_SAMPLE_PERIOD_MS	5		//Encoder_Update() call period
+#define ENCODER_MT_SWITCH_COUNTS	16		//Below this many counts per sample the T method is used
+#define ENCODER_T_TIMEOUT_US		50000	//No edge for this long: wheel considered stopped
+#define ENCODER_SPEED_FILTER_ALPHA	0.3f	//First order IIR weight of the new sample
+
+
+/*
+ * Define wheel name
+ */
+#define ENCODER_LEFT		0
+#define ENCODER_RIGHT		1
+
+
+/*
+ * Speed measurement method used for the last sample
+ */
+#define ENCODER_METHOD_M	0
+#define ENCODER_METHOD_T	1
+
+
+/**
+  * @brief  Per-wheel odometry state
+  */
+typedef struct
+{
+	TIM_HandleTypeDef	hTIM;			/*!< Quadrature counter							*/
+	int8_t				Sign;			/*!< +1 or -1, maps counting direction to forward	*/
+	uint16_t			LastCount;		/*!< Counter value at the previous sample			*/
+	int32_t				Position;		/*!< Accumulated counts, forward positive			*/
+
+	__vo uint16_t		LastCapture;	/*!< Timestamp of the last phase A edge (ISR)		*/
+	__vo uint16_t		Period;			/*!< Last phase A period in capture ticks, 0 after an overcapture (ISR)	*/
+	__vo uint8_t		CaptureSeq;		/*!< Incremented by the ISR on every edge			*/
+
+	uint8_t				SeenSeq;		/*!< Last CaptureSeq consumed by Encoder_Update	*/
+	uint8_t				Stale;			/*!< Capture timer may have wrapped since the last edge	*/
+	uint32_t			ValidPeriod;	/*!< Last trusted period in capture ticks, 0 if none	*/
+	uint32_t			SinceEdge;		/*!< Capture ticks since the last edge				*/
+
+	uint8_t				Method;			/*!< ENCODER_METHOD_M or ENCODER_METHOD_T			*/
+	float				Speed;			/*!< Filtered wheel speed in rad/s					*/
+	float				Distance;		/*!< Travelled distance in m						*/
+}Encoder_Wheel_t;
+
+
+/*
+ * User function
+ */
+void Encoder_Init(void);
+void Encoder_Update(void);
+float Encoder_GetSpeed(_Bool Wheel);
+float Encoder_GetDistance(_Bool Wheel);
+uint8_t Encoder_GetMethod(_Bool Wheel);
+void Encoder_Reset(void);
+
+#endif /* INC_ENCODER_H_ */
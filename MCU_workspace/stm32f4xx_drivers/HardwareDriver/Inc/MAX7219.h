@@ -10,6 +10,27 @@
 
 #include "stm32f407xx.h"
 
+/**
+ * Chip select (LOAD) driven by software: the rising edge latches one 16-bit command,
+ * so SPI stays enabled for the whole refresh and only CS toggles between commands.
+ */
+#define MAX7219_CS_PORT          GPIOA
+#define MAX7219_CS_PIN           GPIO_PIN_4
+
+#define MAX7219_DIGIT_COUNT      8
+
+/**
+ * Number of daisy-chained modules (DOUT of module n to DIN of module n+1).
+ * Module 0 is the one wired to the MCU. Every digit register is refreshed for all
+ * modules at once: one CS frame of MAX7219_MODULE_COUNT commands per row.
+ */
+#define MAX7219_MODULE_COUNT     1
+#define MAX7219_ROW_BYTES        (2 * MAX7219_MODULE_COUNT)
+
+#define MAX7219_DMA_ALLOCATION   DMA_ALLOC_DISPLAY_TX
+#define MAX7219_TX_TIMEOUT_MS    5		//A full DMA refresh takes well under 1 ms
+#define MAX7219_ANIM_FRAME_MS    50		//Shortest keyframe, MAX7219_Anim_Update() must run at least this often
+
 /**
  * MAX7221 register definition
  */
@@ -78,8 +99,40 @@
 #define MAX7219_SCAN_DIGIT_0_7    0x07  /**< Display digits 0 to 7 (default) */
 
 
+/**
+ * @brief One keyframe: digit values held for DurationMs
+ */
+typedef struct
+{
+	uint8_t		Digits[MAX7219_DIGIT_COUNT];	/*!< Segment patterns of digit 0..7			*/
+	uint16_t	DurationMs;						/*!< Time before the next keyframe			*/
+}MAX7219_Keyframe_t;
+
+/**
+ * @brief Animation: keyframe table played on a subset of the digits. The keyframes are
+ *        raw segment patterns, the digits it owns must be in no-decode mode.
+ */
+typedef struct
+{
+	const MAX7219_Keyframe_t	*pFrames;
+	uint8_t						FrameCount;
+	uint8_t						DigitMask;		/*!< Bit n set: the animation owns digit n	*/
+}MAX7219_Animation_t;
+
+/**
+ * @brief Built-in animations
+ */
+extern const MAX7219_Animation_t MAX7219_AnimLeftSignal;
+extern const MAX7219_Animation_t MAX7219_AnimRightSignal;
+extern const MAX7219_Animation_t MAX7219_AnimStopSignal;
+
+
 void MAX7219_SendCommand(SPI_RegDef_t* SPIx, uint8_t Address, uint8_t Data);
 void MAX7219_SetDigitValue(SPI_RegDef_t* SPIx, uint8_t Digit, uint8_t Value);
+void MAX7219_SetModuleDigit(uint8_t Module, uint8_t Digit, uint8_t Value);
+void MAX7219_Flush(SPI_RegDef_t* SPIx);
+void MAX7219_EnableDMA(SPI_RegDef_t* SPIx);
+_Bool MAX7219_IsBusy(void);
 void MAX7219_Init(SPI_RegDef_t* SPIx, uint8_t DecodeMode, uint8_t IntensityLevel, uint8_t ScanLimit);
 void MAX7219_TestLED(SPI_RegDef_t* SPIx, _Bool IsEnabled);
 void MAX7219_Clean(SPI_RegDef_t* SPIx);
@@ -88,4 +141,11 @@ void MAX7219_LeftSignal(SPI_RegDef_t* SPIx);
 void MAX7219_RightSignal(SPI_RegDef_t* SPIx);
 void MAX7219_StopSignal(SPI_RegDef_t* SPIx);
 
+void MAX7219_Anim_Play(const MAX7219_Animation_t* pAnim, _Bool Loop);
+void MAX7219_Anim_Chain(const MAX7219_Animation_t* pAnim, _Bool Loop);
+void MAX7219_Anim_Stop(void);
+_Bool MAX7219_Anim_Update(void);
+_Bool MAX7219_Anim_IsRunning(void);
+uint8_t MAX7219_Anim_GetDigitMask(void);
+
 #endif /* INC_MAX7219_H_ */
@@ -14,6 +14,7 @@
 #define MPU6050_WHO_AM_I		0x75
 
 #define MPU6050_REG_PWR_MGMT_1  	0x6B
+#define MPU6050_REG_SMPLRT_DIV  	0x19
 #define MPU6050_REG_ACCEL_XOUT_H 	0x3B
 #define MPU6050_REG_GYRO_XOUT_H  	0x43
 #define MPU6050_REG_CONFIG      	0x1A
@@ -22,6 +23,98 @@
 #define MPU6050_REG_INT_ENABLE 	 	0x38
 #define MPU6050_REG_INT_STATUS 	 	0x3A
 
+/*
+ * Start-up: the gyro needs ~30 ms after wake-up before its output is valid (datasheet
+ * start-up time). MPU6050_Init() only wakes the sensor, the rest of the init runs while
+ * it settles and MPU6050_WaitReady() waits for what is left.
+ */
+#define MPU6050_STARTUP_MS			35
+#define MPU6050_CALIB_SAMPLES		1000		//Gyro bias samples, one per 1 ms output sample (1 s)
+#define MPU6050_CALIB_MAX_NOISE_DPS	0.5			//Above this spread the robot moved during calibration
+
+/*
+ * Accelerometer six-position calibration: the robot is laid still on each of its six
+ * faces, in any order. Per axis a least-squares line through the six readings gives
+ * the offset (mean of the six) and the gain (2 g over the up/down difference).
+ * The fit is per axis only, with no cross-axis terms: sensor misalignment and
+ * non-orthogonal axes are not corrected.
+ */
+#define MPU6050_GRAVITY_MPS2			9.81
+#define MPU6050_ACCEL_CALIB_SAMPLES		500		//Samples averaged per face, 0.5 s at 1 kHz
+#define MPU6050_ACCEL_CALIB_MAX_NOISE	0.3		//m/s2, above this the robot is being handled
+#define MPU6050_ACCEL_CALIB_MIN_AXIS	0.8		//Vertical axis reads at least this share of g
+#define MPU6050_ACCEL_CALIB_MAX_GAIN_ERR	0.15	//Fits further than this from 1 are rejected
+
+/*
+ * Gyro bias temperature compensation (pitch axis). Each calibration at boot gives one
+ * (temperature, bias) point; a line is fitted over the points of the past boots and kept in
+ * the parameter store. The bias measured at boot stays the reference, only the slope of
+ * the fit is used: bias(T) = bias_boot + slope * (T - T_boot).
+ * Old points fade out once MPU6050_TEMPCOMP_MAX_POINTS are reached, so the fit follows
+ * aging of the sensor.
+ */
+#define MPU6050_TEMP_SCALE			(1.0 / 340.0)	//degC per LSB
+#define MPU6050_TEMP_OFFSET_C		36.53
+#define MPU6050_TEMPCOMP_MIN_POINTS	4
+#define MPU6050_TEMPCOMP_MAX_POINTS	32
+#define MPU6050_TEMPCOMP_MIN_SPREAD_C	3.0f	//Standard deviation of the point temperatures
+#define MPU6050_TEMPCOMP_MAX_SLOPE	0.2f		//dps/degC, datasheet bias drift is well below
+
+/*
+ * Digital low pass filter (CONFIG.DLPF_CFG), accel / gyro bandwidth.
+ * Filter group delay, gyro: 0.98, 1.9, 2.8, 4.8, 8.3, 13.4, 18.6 ms.
+ */
+#define MPU6050_DLPF_260HZ			0		//Gyro output rate 8 kHz, 1 kHz for all others
+#define MPU6050_DLPF_184HZ			1
+#define MPU6050_DLPF_94HZ			2
+#define MPU6050_DLPF_44HZ			3
+#define MPU6050_DLPF_21HZ			4
+#define MPU6050_DLPF_10HZ			5
+#define MPU6050_DLPF_5HZ			6
+
+/*
+ * Gyro full scale (GYRO_CONFIG.FS_SEL)
+ */
+#define MPU6050_GYRO_FS_250DPS		0
+#define MPU6050_GYRO_FS_500DPS		1
+#define MPU6050_GYRO_FS_1000DPS		2
+#define MPU6050_GYRO_FS_2000DPS		3
+
+/*
+ * Accelerometer full scale (ACCEL_CONFIG.AFS_SEL)
+ */
+#define MPU6050_ACCEL_FS_2G			0
+#define MPU6050_ACCEL_FS_4G			1
+#define MPU6050_ACCEL_FS_8G			2
+#define MPU6050_ACCEL_FS_16G		3
+
+/*
+ * Auto-ranging: a sample near full scale widens the range by one step, a calm period
+ * narrows it again down to the configured range. Samples taken while a new range
+ * settles are not converted, the last converted values are kept instead.
+ */
+#define MPU6050_AUTORANGE_UP_LSB		28000	//~85 % of full scale: widen
+#define MPU6050_AUTORANGE_DOWN_LSB		12000	//~73 % of the narrower full scale: may narrow
+#define MPU6050_AUTORANGE_CALM_SAMPLES	200		//Samples below the down threshold before narrowing
+#define MPU6050_AUTORANGE_SETTLE_SAMPLES	3	//Samples dropped after a range change
+
+/*
+ * MPU6050_Data.settling flags
+ */
+#define MPU6050_SETTLING_GYRO		0x01
+#define MPU6050_SETTLING_ACCEL		0x02
+
+/**
+  * @brief  Sensor configuration, applied by MPU6050_InitConfig()
+  */
+typedef struct {
+	uint8_t DLPF;				/*!< Value of @ref MPU6050_DLPF_44HZ					*/
+	uint8_t SampleRateDiv;		/*!< Output rate = gyro output rate / (1 + SampleRateDiv)	*/
+	uint8_t GyroRange;			/*!< Value of @ref MPU6050_GYRO_FS_250DPS				*/
+	uint8_t AccelRange;			/*!< Value of @ref MPU6050_ACCEL_FS_2G					*/
+	uint8_t AutoRange;			/*!< ENABLE: ranges widen on the fly from the values above	*/
+} MPU6050_Config;
+
 typedef struct {
     int16_t accel_x;
     int16_t accel_y;
@@ -29,6 +122,10 @@ typedef struct {
     int16_t gyro_x;
     int16_t gyro_y;
     int16_t gyro_z;
+    int16_t temp;               // Die temperature, MPU6050_TEMP_SCALE per LSB
+    uint8_t gyro_range;         // Full scale the sample was taken with
+    uint8_t accel_range;
+    uint8_t settling;           // MPU6050_SETTLING_x: scale of the sample unknown
 } MPU6050_Data;
 
 typedef struct {
@@ -38,13 +135,57 @@ typedef struct {
 	double gyro_x_dps;
 	double gyro_y_dps;
 	double gyro_z_dps;
+	double temp_c;
 } MPU6050_ConvertedData;
 
+/**
+  * @brief  Gyro bias from the boot calibration, stored as PARAMSTORE_ID_GYRO_CALIB.
+  *         The stored value stands in when the robot is moved during calibration.
+  */
+typedef struct {
+	float Bias[3];				/*!< X, Y, Z bias (dps)								*/
+	float TempC;				/*!< Die temperature during the calibration			*/
+} MPU6050_GyroCalib;
+
+/**
+  * @brief  Accelerometer correction a = Gain * (a_raw - Offset), stored as PARAMSTORE_ID_ACCEL_CALIB
+  */
+typedef struct {
+	float Offset[3];			/*!< X, Y, Z offset (m/s2)							*/
+	float Gain[3];				/*!< X, Y, Z scale correction, 1 when ideal			*/
+} MPU6050_AccelCalib;
+
+/**
+  * @brief  Gyro X bias vs temperature fit, stored as PARAMSTORE_ID_GYRO_TEMP
+  */
+typedef struct {
+	float Points;				/*!< Weight of the points in the sums				*/
+	float SumT;					/*!< Sum of the temperatures (degC)					*/
+	float SumB;					/*!< Sum of the biases (dps)						*/
+	float SumTT;
+	float SumTB;
+	float Slope;				/*!< dps/degC, 0 until the fit is usable			*/
+} MPU6050_TempModel;
+
 I2C_StatusTypeDef MPU6050_Init(I2C_HandleTypeDef *hi2c);
+I2C_StatusTypeDef MPU6050_InitConfig(I2C_HandleTypeDef *hi2c, const MPU6050_Config *config);
+const MPU6050_Config *MPU6050_GetConfig(void);
+uint32_t MPU6050_GetSampleRateHz(void);
+uint32_t MPU6050_GetGyroDelayUs(void);
+uint32_t MPU6050_GetAccelDelayUs(void);
+uint8_t MPU6050_GetGyroRange(void);
+uint8_t MPU6050_GetAccelRange(void);
 I2C_StatusTypeDef MPU6050_ReadData(I2C_HandleTypeDef *hi2c, MPU6050_Data *data);
 I2C_StatusTypeDef MPU6050_CheckDevice(I2C_HandleTypeDef *hi2c);
 void MPU6050_ConvertData(const MPU6050_Data *raw_data, MPU6050_ConvertedData *converted_data);
+void MPU6050_WaitReady(void);
 void MPU6050_CalibGyro(void);
+uint8_t MPU6050_CalibAccel(void (*Progress)(uint8_t Captured));
+const MPU6050_GyroCalib *MPU6050_GetGyroCalib(void);
+const MPU6050_AccelCalib *MPU6050_GetAccelCalib(void);
+uint8_t MPU6050_LearnTempModel(void);
+const MPU6050_TempModel *MPU6050_GetTempModel(void);
+double MPU6050_GetGyroBias(double temp_c);
 double MPU6050_GetAngle(const MPU6050_ConvertedData *data);
 
 
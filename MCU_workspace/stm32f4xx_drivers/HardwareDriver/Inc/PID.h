@@ -8,16 +8,43 @@
 #ifndef INC_PID_H_
 #define INC_PID_H_
 
+/*
+ * The D term acts on the measurement, not on the error: a setpoint step gives no kick.
+ * PID_Compute() differentiates the measurement over its own time base; PID_ComputeRate()
+ * takes a measured rate instead (e.g. the gyro for a tilt loop), which is cleaner and
+ * cheaper. Either way the D term can go through a first-order low pass.
+ *
+ * The output is clamped to [out_min, out_max]. The integrator holds the I term itself
+ * (Ki already applied), so a gain change does not make the output jump. It stops
+ * integrating while the output is saturated in the direction the error pushes (conditional
+ * integration), and is clamped to [i_min, i_max]. All limits are open after PID_Init().
+ */
+#define PID_DT_MEASURED		0.0		//dt argument: time the calls with getMicros()
+
 typedef struct
 {
 	double Kp;
 	double Ki;
 	double Kd;
-	double integral;
-	double prev_error;
+	double integral;		// I term, in output units
+	double out_min;
+	double out_max;
+	double i_min;
+	double i_max;
+	double prev_measured;
+	double d_term;			// D term after the filter
+	double d_tau;			// D filter time constant in s, 0 for none
+	uint32_t last_us;		// Time of the last PID_Compute(), per controller
+	uint8_t primed;			// prev_measured and last_us are valid
 }PID_Controller;
 
 
 void PID_Init(PID_Controller *pid, double Kp, double Ki, double Kd);
+void PID_SetDerivativeFilter(PID_Controller *pid, double tau);
+void PID_SetTunings(PID_Controller *pid, double Kp, double Ki, double Kd);
+void PID_SetOutputLimits(PID_Controller *pid, double min, double max);
+void PID_SetIntegralLimits(PID_Controller *pid, double min, double max);
+void PID_Reset(PID_Controller *pid);
 double PID_Compute(PID_Controller *pid, double setpoint, double measured);
+double PID_ComputeRate(PID_Controller *pid, double setpoint, double measured, double rate, double dt);
 #endif /* INC_PID_H_ */
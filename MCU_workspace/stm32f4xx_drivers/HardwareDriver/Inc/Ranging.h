@@ -0,0 +1,73 @@
+/*
+ * Ranging.h
+ *
+ *  Created on: Jul 11, 2025
+ *      Author: quanvm198
+ */
+
+#ifndef INC_RANGING_H_
+#define INC_RANGING_H_
+
+#include "stm32f407xx.h"
+
+
+/*
+ * Sensors owned by the manager, fired one at a time in this order
+ */
+#define RANGING_SENSOR_FRONT		0	//Trigger/echo module on TIM5
+#define RANGING_SENSOR_REAR			1	//SR05 on USART2
+#define RANGING_SENSOR_COUNT		2
+
+/*
+ * Each sensor gets a slot of its own: the next one is only triggered when the echoes
+ * of the previous one have died out, so a sensor never hears another sensor's burst.
+ * The slot is the HC-SR04 minimum measurement cycle (60 ms, the echo pulse itself ends
+ * within 38 ms): a late echo of the previous ping cannot be taken for the current one.
+ * It is also the period of the ranging task, one slot per call.
+ */
+#define RANGING_SLOT_MS				60
+
+/*
+ * Status of a table entry
+ */
+#define RANGING_STATUS_NONE				0	//No answer yet
+#define RANGING_STATUS_VALID			1
+#define RANGING_STATUS_OUT_OF_RANGE		2	//No echo, or distance outside the sensor range
+#define RANGING_STATUS_NO_RESPONSE		3	//Last trigger got no answer within its slot
+
+#define RANGING_AGE_NEVER			0xFFFFFFFFU
+
+
+/**
+  * @brief  Access functions of one ultrasonic driver
+  */
+typedef struct
+{
+	void		(*Init)(void);
+	void		(*Trigger)(void);
+	void		(*Process)(void);			/*!< Main loop work, NULL if none			*/
+	uint16_t	(*GetDistance)(void);		/*!< Last valid distance in mm				*/
+	uint32_t	(*GetTimestamp)(void);		/*!< getTick() of the last answer			*/
+	uint8_t		(*GetStatus)(void);			/*!< Values match @ref RANGING_STATUS_VALID	*/
+}Ranging_Driver_t;
+
+/**
+  * @brief  Latest result of one sensor
+  */
+typedef struct
+{
+	uint16_t	Distance;		/*!< Last valid distance in mm						*/
+	uint32_t	Timestamp;		/*!< getTick() of the last answer					*/
+	uint8_t		Status;			/*!< Value of @ref RANGING_STATUS_NONE				*/
+	uint8_t		Valid;			/*!< Set once Timestamp holds a real answer			*/
+}Ranging_Entry_t;
+
+
+void Ranging_Init(void);
+void Ranging_Process(void);
+const Ranging_Entry_t *Ranging_GetEntry(uint8_t Sensor);
+uint16_t Ranging_GetDistance(uint8_t Sensor);
+uint32_t Ranging_GetAge(uint8_t Sensor);
+uint8_t Ranging_GetStatus(uint8_t Sensor);
+
+#endif /* INC_RANGING_H_ */
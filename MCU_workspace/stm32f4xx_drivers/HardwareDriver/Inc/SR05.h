@@ -10,6 +10,96 @@
 
 #include "stm32f407xx.h"
 
-uint16_t SR05_ReadData(USART_HandleTypeDef* pUSART);
+
+/*
+ * Sensor link: the SR05 answers with 4-byte frames (0xFF, DATA_H, DATA_L, SUM) on its TX pin.
+ * In controlled output mode a measurement is only taken when a byte is sent to its RX pin.
+ */
+#define SR05_USART				USART2		//PD5 -> sensor RX, PD6 <- sensor TX
+#define SR05_BAUDRATE			USART_BAUDRATE_9600
+#define SR05_IRQ				IRQ_NO_USART2
+#define SR05_IRQ_PRIORITY		IRQ_PRIO_RANGING
+#define SR05_DMA_ALLOCATION		DMA_ALLOC_RANGER_RX
+#define SR05_TRIGGER_BYTE		0x55
+
+/*
+ * Circular DMA buffer. 128 bytes hold ~130 ms of line traffic at 9600 baud,
+ * SR05_Process() must run more often than that.
+ */
+#define SR05_RX_BUFFER_SIZE		128
+
+/*
+ * Frame format
+ */
+#define SR05_FRAME_SIZE			4
+#define SR05_FRAME_HEADER		0xFF
+#define SR05_FRAME_RESERVED		0xAA		//0xFF 0xAA 0xAA: no valid echo
+
+/*
+ * Measuring range in sensor units (mm), readings outside it are counted as out of range
+ */
+#define SR05_DISTANCE_MIN		30
+#define SR05_DISTANCE_MAX		4500
+
+
+/*
+ * Parser result for one byte
+ */
+#define SR05_PARSE_NONE				0	//Frame not complete yet
+#define SR05_PARSE_VALID			1	//Valid measurement in pParser->Distance
+#define SR05_PARSE_OUT_OF_RANGE		2	//Good checksum, reserved frame or distance outside the range
+#define SR05_PARSE_CHECKSUM_ERROR	3	//Frame dropped
+
+/*
+ * Parser states
+ */
+#define SR05_STATE_HEADER		0
+#define SR05_STATE_DATA_H		1
+#define SR05_STATE_DATA_L		2
+#define SR05_STATE_SUM			3
+
+
+/**
+  * @brief  Frame statistics
+  */
+typedef struct
+{
+	uint32_t	ValidFrames;		/*!< Frames with a good checksum and an in-range distance	*/
+	uint32_t	OutOfRange;			/*!< Reserved frames and distances outside the range		*/
+	uint32_t	ChecksumErrors;		/*!< Complete frames dropped on a bad checksum				*/
+	uint32_t	Resyncs;			/*!< Times the parser had to hunt for a header				*/
+}SR05_Stats_t;
+
+/**
+  * @brief  Resumable frame parser, can be fed any number of bytes at a time
+  */
+typedef struct
+{
+	uint8_t			State;			/*!< Position in the frame @ref SR05_STATE_HEADER	*/
+	uint8_t			High;			/*!< DATA_H of the frame being parsed				*/
+	uint8_t			Low;			/*!< DATA_L of the frame being parsed				*/
+	uint8_t			Hunting;		/*!< Set while bytes are discarded before a header	*/
+	uint16_t		Distance;		/*!< Last valid distance							*/
+	SR05_Stats_t	Stats;
+}SR05_Parser_t;
+
+
+/*
+ * Parser, independent of the transport
+ */
+void SR05_Parser_Init(SR05_Parser_t *pParser);
+uint8_t SR05_Parser_PutByte(SR05_Parser_t *pParser, uint8_t Byte);
+uint8_t SR05_Parser_Feed(SR05_Parser_t *pParser, const uint8_t *pData, uint16_t Len);
+
+/*
+ * Sensor on the DMA ring buffer
+ */
+void SR05_Init(void);
+void SR05_Trigger(void);
+void SR05_Process(void);
+uint16_t SR05_GetDistance(void);
+uint32_t SR05_GetTimestamp(void);
+uint8_t SR05_GetStatus(void);
+const SR05_Stats_t *SR05_GetStats(void);
 
 #endif /* INC_SR05_H_ */
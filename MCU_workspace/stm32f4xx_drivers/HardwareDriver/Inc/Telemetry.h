@@ -0,0 +1,74 @@
+/*
+ * Telemetry.h
+ *
+ *  Created on: Jul 13, 2025
+ *      Author: quanvm198
+ */
+
+#ifndef INC_TELEMETRY_H_
+#define INC_TELEMETRY_H_
+
+#include "stm32f407xx.h"
+#include "BootProfile.h"
+
+
+/*
+ * Link: binary frames on USART1 TX (PA9), sent by DMA so a frame costs the CPU only
+ * the packing. At 115200 baud a frame takes ~2.3 ms, well below the 10 ms send period.
+ */
+#define TELEMETRY_USART				USART1
+#define TELEMETRY_BAUDRATE			USART_BAUDRATE_115200
+#define TELEMETRY_DMA_ALLOCATION	DMA_ALLOC_TELEMETRY_TX
+
+/*
+ * Frame: SYNC0 SYNC1 LEN TYPE SEQ payload[LEN] CHECKSUM
+ * CHECKSUM is the 8-bit sum of LEN, TYPE, SEQ and the payload. Little endian fields.
+ */
+#define TELEMETRY_SYNC0				0xA5
+#define TELEMETRY_SYNC1				0x5A
+#define TELEMETRY_HEADER_SIZE		5
+
+/*
+ * Frame types
+ */
+#define TELEMETRY_TYPE_SAMPLE		0x01	//Telemetry_Sample_t, every send period
+#define TELEMETRY_TYPE_BOOT			0x02	//Telemetry_Boot_t, once after start-up
+
+/**
+  * @brief  Payload of one frame
+  */
+typedef struct __attribute__((packed))
+{
+	uint32_t	Tick;			/*!< getTick() when the sample was taken		*/
+	int16_t		Angle;			/*!< Tilt in 0.01 deg							*/
+	int16_t		Output;			/*!< Motor command								*/
+	int16_t		SpeedLeft;		/*!< Wheel speed in 0.01 rad/s					*/
+	int16_t		SpeedRight;
+	uint16_t	RangeFront;		/*!< Distance in mm								*/
+	uint16_t	RangeRear;
+	uint16_t	Overruns;		/*!< Scheduler overruns since start				*/
+	uint16_t	CpuLoad;		/*!< Busy time in 0.1 %							*/
+	uint16_t	ControlExecUs;	/*!< Mean run time of one balance loop iteration	*/
+	int16_t		Setpoint;		/*!< Learned balance point in 0.01 deg			*/
+}Telemetry_Sample_t;
+
+/**
+  * @brief  Payload of the boot report
+  */
+typedef struct __attribute__((packed))
+{
+	uint32_t	BootCount;
+	uint8_t		PrevLastPhase;					/*!< Last phase of the previous boot	*/
+	uint32_t	PhaseUs[BOOT_PHASE_COUNT];		/*!< Phase end from reset in us			*/
+}Telemetry_Boot_t;
+
+#define TELEMETRY_PAYLOAD_MAX		sizeof(Telemetry_Boot_t)
+#define TELEMETRY_FRAME_MAX			(TELEMETRY_HEADER_SIZE + TELEMETRY_PAYLOAD_MAX + 1)
+
+
+void Telemetry_Init(void);
+uint8_t Telemetry_Send(const Telemetry_Sample_t *pSample);
+uint8_t Telemetry_SendBoot(void);
+uint32_t Telemetry_GetDropped(void);
+
+#endif /* INC_TELEMETRY_H_ */
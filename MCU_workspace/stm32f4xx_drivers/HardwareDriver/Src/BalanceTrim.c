@@ -0,0 +1,96 @@
+/*
+ * BalanceTrim.c
+ *
+ *  Created on: Jul 16, 2025
+ *      Author: quanvm198
+ */
+
+#include "BalanceTrim.h"
+#include "ParamStore.h"
+
+static float BalanceTrim_Setpoint;		//deg
+static float BalanceTrim_Saved;			//Value of the last stored record
+static float BalanceTrim_Effort;		//Filtered balance output
+static float BalanceTrim_Speed;			//Filtered wheel speed
+static uint32_t BalanceTrim_SaveTick;
+
+static void BalanceTrim_Save(void);
+
+/**
+  * @brief  Loads the stored balance point, 0 deg if none. Runs at boot, before the motors start.
+  * @retval None
+  */
+void BalanceTrim_Init(void){
+  float trim;
+
+  BalanceTrim_Setpoint = 0.0f;
+  if(ParamStore_Read(PARAMSTORE_ID_BALANCE_TRIM, &trim, sizeof(trim)) == PARAMSTORE_OK &&
+     trim >= -BALANCETRIM_LIMIT_DEG && trim <= BALANCETRIM_LIMIT_DEG){
+      BalanceTrim_Setpoint = trim;
+  }
+
+  BalanceTrim_Saved = BalanceTrim_Setpoint;
+  BalanceTrim_Effort = 0.0f;
+  BalanceTrim_Speed = 0.0f;
+  BalanceTrim_SaveTick = getTick();
+}
+
+/**
+  * @brief  One estimator step.
+  * @param  Angle: Tilt estimate (deg)
+  * @param  Output: Balance command applied (PWM counts)
+  * @param  WheelSpeed: Mean speed of both wheels (rad/s, forward positive)
+  * @param  Dt: Time since the previous call (s)
+  * @retval None
+  */
+void BalanceTrim_Update(double Angle, double Output, float WheelSpeed, float Dt){
+  //Fallen or being picked up: effort and speed say nothing about the balance point
+  if(fabs(Angle - BalanceTrim_Setpoint) > BALANCETRIM_ACTIVE_DEG){
+      BalanceTrim_Effort = 0.0f;
+      BalanceTrim_Speed = 0.0f;
+      return;
+  }
+
+  float alpha = Dt / BALANCETRIM_FILTER_TAU_S;
+  BalanceTrim_Effort += alpha * ((float)Output - BalanceTrim_Effort);
+  BalanceTrim_Speed += alpha * (WheelSpeed - BalanceTrim_Speed);
+
+  //Steady forward effort and creep mean the robot leans forward of its balance point
+  float rate = BALANCETRIM_SIGN * (BALANCETRIM_GAIN_EFFORT * BalanceTrim_Effort + BALANCETRIM_GAIN_SPEED * BalanceTrim_Speed);
+  if(rate > BALANCETRIM_MAX_RATE_DPS) rate = BALANCETRIM_MAX_RATE_DPS;
+  if(rate < -BALANCETRIM_MAX_RATE_DPS) rate = -BALANCETRIM_MAX_RATE_DPS;
+
+  BalanceTrim_Setpoint += rate * Dt;
+  if(BalanceTrim_Setpoint > BALANCETRIM_LIMIT_DEG) BalanceTrim_Setpoint = BALANCETRIM_LIMIT_DEG;
+  if(BalanceTrim_Setpoint < -BALANCETRIM_LIMIT_DEG) BalanceTrim_Setpoint = -BALANCETRIM_LIMIT_DEG;
+
+  if((uint32_t)(getTick() - BalanceTrim_SaveTick) >= BALANCETRIM_SAVE_PERIOD_MS){
+      BalanceTrim_SaveTick = getTick();
+      BalanceTrim_Save();
+  }
+}
+
+/**
+  * @brief  Returns the balance setpoint.
+  * @retval Setpoint (deg)
+  */
+double BalanceTrim_Get(void){
+  return BalanceTrim_Setpoint;
+}
+
+
+/**
+  * @brief  Stores the setpoint when it moved. Appends only, never erases: when the store is
+  *         full the value is lost until ParamStore_Reserve() makes room at the next boot.
+  */
+static void BalanceTrim_Save(void){
+  float trim = BalanceTrim_Setpoint;
+
+  if(fabsf(trim - BalanceTrim_Saved) < BALANCETRIM_SAVE_DELTA_DEG){
+      return;
+  }
+
+  if(ParamStore_Append(PARAMSTORE_ID_BALANCE_TRIM, &trim, sizeof(trim)) == PARAMSTORE_OK){
+      BalanceTrim_Saved = trim;
+  }
+}
@@ -8,60 +8,158 @@
 #include "DCMotor.h"
 #include <stdlib.h>
 
-#define PWM_MAX 999
+static int16_t Motor_Saturate(int32_t ControlSignal);
+static uint32_t Motor_ToCompare(int16_t ControlSignal);
+static void Motor_DirectionMasks(_Bool Motor, uint8_t Direction, uint16_t *pSetMask, uint16_t *pResetMask);
+
+//PWM timer driving ENA (left) and ENB (right)
+static TIM_HandleTypeDef Motor_hTIM;
+
+//Timer counts per PWM period, used to scale a +/-PWM_MAX command to a compare value
+static uint32_t Motor_PWMPeriod = PWM_MAX + 1;
 
 void Motor_Init(){
   Motor_ConfigIN_GPIO();
-  Motor_ConfigPWMSource();  //PWM at PA0
+  Motor_ConfigPWMSource();  //PWM at PA0 (left) and PA1 (right)
 
 }
 
 void Motor_ConfigIN_GPIO(){
-  //Configure GPIO mode as output to connect to L298N IN1 and IN2 pin
+  //Configure GPIO mode as output to connect to L298N IN1..IN4 pin
   GPIO_Initialize(L298N_IN1_PORT, L298N_IN1_PIN, GPIO_MODE_OUTPUT);
   GPIO_Initialize(L298N_IN2_PORT, L298N_IN2_PIN, GPIO_MODE_OUTPUT);
+  GPIO_Initialize(L298N_IN3_PORT, L298N_IN3_PIN, GPIO_MODE_OUTPUT);
+  GPIO_Initialize(L298N_IN4_PORT, L298N_IN4_PIN, GPIO_MODE_OUTPUT);
 }
 
 
 void Motor_ConfigPWMSource(){
-  TIM_PWM_Init(TIM2, TIM_CHANNEL_1);
+  Motor_hTIM.pTIMx = MOTOR_PWM_TIM;
+  Motor_hTIM.Init.CounterMode = TIM_COUNTERMODE_UP;
+  Motor_hTIM.Init.Prescaler = 0;
+  Motor_hTIM.Init.Period = PWM_MAX;
+
+  TIM_PWM_Init(&Motor_hTIM, MOTOR_LEFT_PWM_CHANNEL);
+  TIM_PWM_Init(&Motor_hTIM, MOTOR_RIGHT_PWM_CHANNEL);
+
+  uint32_t period = TIM_PWM_SetFrequency(&Motor_hTIM, MOTOR_PWM_FREQUENCY_HZ);
+  if(period){
+      Motor_PWMPeriod = period;
+  }
+
+  //Compare values are latched on the update event so both wheels change together
+  TIM_SetOCPreload(MOTOR_PWM_TIM, MOTOR_LEFT_PWM_CHANNEL, ENABLE);
+  TIM_SetOCPreload(MOTOR_PWM_TIM, MOTOR_RIGHT_PWM_CHANNEL, ENABLE);
 }
 
 
 
 
-void Motor_ConfigDirection(_Bool Motor, _Bool Direction){
-  if(Motor == MOTOR_LEFT){
-      if(Direction == MOTOR_DIR_FORWARD){
-	  GPIO_WritePin(L298N_IN1_PORT, L298N_IN1_PIN, 1);
-	  GPIO_WritePin(L298N_IN2_PORT, L298N_IN2_PIN, 0);
-      }
-      else if (Direction == MOTOR_DIR_BACKWARD){
-	  GPIO_WritePin(L298N_IN1_PORT, L298N_IN1_PIN, 0);
-	  GPIO_WritePin(L298N_IN2_PORT, L298N_IN2_PIN, 1);
-      }
+void Motor_ConfigDirection(_Bool Motor, uint8_t Direction){
+  uint16_t setMask, resetMask;
 
-      else{
-	  GPIO_WritePin(L298N_IN1_PORT, L298N_IN1_PIN, 1);
-	  GPIO_WritePin(L298N_IN2_PORT, L298N_IN2_PIN, 1);
-      }
-  }
+  Motor_DirectionMasks(Motor, Direction, &setMask, &resetMask);
+  GPIO_WritePinsFast(L298N_IN_PORT, setMask, resetMask);
 }
 
 
+/**
+  * @brief  Drives a single motor.
+  * @param  Motor: MOTOR_LEFT or MOTOR_RIGHT.
+  * @param  ControlSignal: Signed command, clamped to +/-PWM_MAX. The sign selects the direction.
+  * @retval None
+  */
 void Motor_Control(_Bool Motor, int16_t ControlSignal){
-	if (ControlSignal > PWM_MAX) ControlSignal = PWM_MAX;
-	if (ControlSignal < -PWM_MAX) ControlSignal = -PWM_MAX;
-  uint16_t ABS_ControlSignal = abs(ControlSignal);
-
-  if(Motor == MOTOR_LEFT){
-      if(ControlSignal < 0){
-	  Motor_ConfigDirection(MOTOR_LEFT, MOTOR_DIR_BACKWARD);
-      }
-      else if(ControlSignal >= 0){
-	  Motor_ConfigDirection(MOTOR_LEFT, MOTOR_DIR_FORWARD);
-      }
-
-      TIM_SetDuty(ABS_ControlSignal);
+  ControlSignal = Motor_Saturate(ControlSignal);
+
+  if(ControlSignal < 0){
+      Motor_ConfigDirection(Motor, MOTOR_DIR_BACKWARD);
+  }
+  else{
+      Motor_ConfigDirection(Motor, MOTOR_DIR_FORWARD);
+  }
+
+  TIM_SetCompare(&Motor_hTIM, (Motor == MOTOR_LEFT) ? MOTOR_LEFT_PWM_CHANNEL : MOTOR_RIGHT_PWM_CHANNEL, Motor_ToCompare(ControlSignal));
+}
+
+/**
+  * @brief  Drives both motors. The two duty cycles are applied on the same PWM update event.
+  * @param  LeftSignal: Signed command of the left wheel, clamped to +/-PWM_MAX.
+  * @param  RightSignal: Signed command of the right wheel, clamped to +/-PWM_MAX.
+  * @retval None
+  */
+void Motor_SetOutputs(int16_t LeftSignal, int16_t RightSignal){
+  LeftSignal = Motor_Saturate(LeftSignal);
+  RightSignal = Motor_Saturate(RightSignal);
+
+  //Both bridges change direction in one store
+  uint16_t leftSet, leftReset, rightSet, rightReset;
+  Motor_DirectionMasks(MOTOR_LEFT, (LeftSignal < 0) ? MOTOR_DIR_BACKWARD : MOTOR_DIR_FORWARD, &leftSet, &leftReset);
+  Motor_DirectionMasks(MOTOR_RIGHT, (RightSignal < 0) ? MOTOR_DIR_BACKWARD : MOTOR_DIR_FORWARD, &rightSet, &rightReset);
+  GPIO_WritePinsFast(L298N_IN_PORT, leftSet | rightSet, leftReset | rightReset);
+
+  TIM_SetDualCompare(&Motor_hTIM, MOTOR_LEFT_PWM_CHANNEL, Motor_ToCompare(LeftSignal),
+		  	  	    MOTOR_RIGHT_PWM_CHANNEL, Motor_ToCompare(RightSignal));
+}
+
+/**
+  * @brief  Differential drive mixer: turns a balance effort and a steering effort into wheel commands.
+  *         Left = Balance + Steering, Right = Balance - Steering.
+  *         Balance has priority: steering is reduced so that neither wheel saturates,
+  *         otherwise a turn request could steal the torque needed to stay upright.
+  * @param  Balance: Common-mode effort from the balance controller.
+  * @param  Steering: Differential effort, positive turns right.
+  * @retval None
+  */
+void Motor_Mix(int16_t Balance, int16_t Steering){
+  int32_t balance = Motor_Saturate(Balance);
+  int32_t headroom = PWM_MAX - abs(balance);
+
+  if(Steering > headroom) Steering = headroom;
+  if(Steering < -headroom) Steering = -headroom;
+
+  Motor_SetOutputs(balance + Steering, balance - Steering);
+}
+
+/**
+  * @brief  Clamps a control signal to +/-PWM_MAX.
+  * @param  ControlSignal: Signed command.
+  * @retval Clamped command.
+  */
+static int16_t Motor_Saturate(int32_t ControlSignal){
+  if (ControlSignal > PWM_MAX) return PWM_MAX;
+  if (ControlSignal < -PWM_MAX) return -PWM_MAX;
+  return (int16_t)ControlSignal;
+}
+
+/**
+  * @brief  Converts a clamped control signal to a compare value of the motor PWM timer.
+  * @param  ControlSignal: Signed command within +/-PWM_MAX.
+  * @retval Compare value.
+  */
+static uint32_t Motor_ToCompare(int16_t ControlSignal){
+  return ((uint32_t)abs(ControlSignal) * Motor_PWMPeriod) / (PWM_MAX + 1);
+}
+
+/**
+  * @brief  Computes the IN pin masks of one H-bridge for a direction.
+  * @param  Motor: MOTOR_LEFT (IN1/IN2) or MOTOR_RIGHT (IN3/IN4).
+  * @param  Direction: MOTOR_DIR_FORWARD, MOTOR_DIR_BACKWARD or MOTOR_DIR_STOP (brake, both high).
+  * @param  pSetMask: Pins to drive high.
+  * @param  pResetMask: Pins to drive low.
+  * @retval None
+  */
+static void Motor_DirectionMasks(_Bool Motor, uint8_t Direction, uint16_t *pSetMask, uint16_t *pResetMask){
+  uint16_t inA = (Motor == MOTOR_LEFT) ? (1U << L298N_IN1_PIN) : (1U << L298N_IN3_PIN);
+  uint16_t inB = (Motor == MOTOR_LEFT) ? (1U << L298N_IN2_PIN) : (1U << L298N_IN4_PIN);
+
+  if(Direction == MOTOR_DIR_FORWARD){
+      *pSetMask = inA; *pResetMask = inB;
+  }
+  else if(Direction == MOTOR_DIR_BACKWARD){
+      *pSetMask = inB; *pResetMask = inA;
+  }
+  else{
+      *pSetMask = inA | inB; *pResetMask = 0;
   }
 }
@@ -0,0 +1,146 @@
+/*
+ * DisplayNumber.c
+ *
+ *  Created on: Jul 12, 2025
+ *      Author: quanvm198
+ */
+
+#include "DisplayNumber.h"
+
+//Symbols of the font tables
+#define DISPLAYNUMBER_SYM_MINUS		10
+#define DISPLAYNUMBER_SYM_BLANK		11
+
+/*
+ * Segment patterns for no-decode digits (bit 7..0 = DP A B C D E F G):
+ * 0..9, minus, blank
+ */
+static const uint8_t DisplayNumber_Segments[12] = {
+    0x7E, 0x30, 0x6D, 0x79, 0x33, 0x5B, 0x5F, 0x70, 0x7F, 0x7B, 0x01, 0x00
+};
+
+//Code B font, same symbol order
+static const uint8_t DisplayNumber_CodeB[12] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+    DISPLAYNUMBER_CODEB_MINUS, DISPLAYNUMBER_CODEB_BLANK
+};
+
+//Largest magnitude that fits in n digits
+static const uint32_t DisplayNumber_Limit[DISPLAYNUMBER_MAX_WIDTH + 1] = {
+    0, 9, 99, 999, 9999, 99999, 999999, 9999999, 99999999
+};
+
+static inline uint32_t DisplayNumber_Div10(uint32_t Value);
+
+/**
+  * @brief  Converts a value into one display code per digit.
+  * @param  Value: Signed value, scaled by 10^DecimalPlaces for fixed point.
+  * @param  DecimalPlaces: Digits after the decimal point (0 for an integer), at most Width - 1.
+  * @param  Width: Field width in digits (1..DISPLAYNUMBER_MAX_WIDTH).
+  * @param  Flags: Combination of DISPLAYNUMBER_FLAG_x.
+  * @param  pCodes: Output, Width codes, least significant digit first.
+  * @retval 1 on success, 0 if the value does not fit (the field is filled with dashes).
+  */
+uint8_t DisplayNumber_Format(int32_t Value, uint8_t DecimalPlaces, uint8_t Width, uint8_t Flags, uint8_t *pCodes){
+  const uint8_t *font = (Flags & DISPLAYNUMBER_FLAG_SEGMENTS) ? DisplayNumber_Segments : DisplayNumber_CodeB;
+  uint8_t symbols[DISPLAYNUMBER_MAX_WIDTH];
+
+  if(Width == 0 || Width > DISPLAYNUMBER_MAX_WIDTH){
+      return 0;
+  }
+
+  //Magnitude in unsigned, INT32_MIN included
+  uint8_t negative = (Value < 0);
+  uint32_t magnitude = negative ? (0U - (uint32_t)Value) : (uint32_t)Value;
+
+  //At least one digit left of the point, plus one for the sign. DecimalPlaces is checked
+  //before it is used: above Width - 1 the point would land outside the field.
+  uint8_t digitWidth = Width - negative;
+  if(DecimalPlaces >= digitWidth || magnitude > DisplayNumber_Limit[digitWidth]){
+      for(uint8_t i = 0; i < Width; i++){
+	  pCodes[i] = font[DISPLAYNUMBER_SYM_MINUS];
+      }
+      return 0;
+  }
+  uint8_t minDigits = DecimalPlaces + 1;
+
+  //Binary to BCD, one reciprocal multiply per digit
+  uint8_t used = 0;
+  do{
+      uint32_t quotient = DisplayNumber_Div10(magnitude);
+      symbols[used++] = (uint8_t)(magnitude - quotient * 10);
+      magnitude = quotient;
+  }while(magnitude || used < minDigits);
+
+  //Sign right before the most significant digit, blanks or zeros beyond
+  uint8_t i = used;
+  if((Flags & DISPLAYNUMBER_FLAG_ZERO_PAD)){
+      while(i < digitWidth){
+	  symbols[i++] = 0;
+      }
+  }
+  if(negative){
+      symbols[i++] = DISPLAYNUMBER_SYM_MINUS;
+  }
+  while(i < Width){
+      symbols[i++] = DISPLAYNUMBER_SYM_BLANK;
+  }
+
+  for(i = 0; i < Width; i++){
+      pCodes[i] = font[symbols[i]];
+  }
+  if(DecimalPlaces){
+      pCodes[DecimalPlaces] |= DISPLAYNUMBER_DP;
+  }
+
+  return 1;
+}
+
+/**
+  * @brief  Writes a formatted value into the framebuffer in one call, MAX7219_Flush() sends
+  *         the digits that changed.
+  * @param  Position: Digit register of the least significant digit (0x01 to 0x08).
+  * @param  Width: Field width in digits, the field must end at or before digit 0x08.
+  * @param  Value: Signed value, scaled by 10^DecimalPlaces for fixed point.
+  * @param  DecimalPlaces: Digits after the decimal point (0 for an integer).
+  * @param  Flags: Combination of DISPLAYNUMBER_FLAG_x.
+  * @retval 1 on success, 0 if the value does not fit (dashes are shown).
+  */
+uint8_t DisplayNumber_Show(uint8_t Position, uint8_t Width, int32_t Value, uint8_t DecimalPlaces, uint8_t Flags){
+  uint8_t codes[DISPLAYNUMBER_MAX_WIDTH];
+
+  if(Width == 0 || Position < MAX7219_REG_DIGIT0 || Position + Width - 1 > MAX7219_REG_DIGIT7){
+      return 0;
+  }
+
+  uint8_t status = DisplayNumber_Format(Value, DecimalPlaces, Width, Flags, codes);
+  for(uint8_t i = 0; i < Width; i++){
+      MAX7219_SetModuleDigit(0, Position + i, codes[i]);
+  }
+
+  return status;
+}
+
+/**
+  * @brief  Blanks a field of the framebuffer.
+  * @param  Position: Digit register of the least significant digit (0x01 to 0x08).
+  * @param  Width: Field width in digits.
+  * @param  Flags: DISPLAYNUMBER_FLAG_SEGMENTS for no-decode digits.
+  * @retval None
+  */
+void DisplayNumber_Blank(uint8_t Position, uint8_t Width, uint8_t Flags){
+  const uint8_t *font = (Flags & DISPLAYNUMBER_FLAG_SEGMENTS) ? DisplayNumber_Segments : DisplayNumber_CodeB;
+
+  for(uint8_t i = 0; i < Width; i++){
+      MAX7219_SetModuleDigit(0, Position + i, font[DISPLAYNUMBER_SYM_BLANK]);
+  }
+}
+
+
+/**
+  * @brief  Value / 10 without a divide: 0xCCCCCCCD / 2^35 is 1/10 rounded up, exact for
+  *         every 32-bit input. The compiler emits a single UMULL.
+  */
+static inline uint32_t DisplayNumber_Div10(uint32_t Value){
+  return (uint32_t)(((uint64_t)Value * 0xCCCCCCCDULL) >> 35);
+}
@@ -0,0 +1,183 @@
+/*
+ * EchoRanger.c
+ *
+ *  Created on: Jul 10, 2025
+ *      Author: quanvm198
+ */
+
+#include "EchoRanger.h"
+
+//Round trip at 343 m/s: 0.1715 mm per us of echo pulse
+#define ECHORANGER_MM_PER_US_NUM	343
+#define ECHORANGER_MM_PER_US_DEN	2000
+
+static TIM_HandleTypeDef EchoRanger_hTIM;
+
+//Written by the capture interrupt
+static uint32_t EchoRanger_RiseCapture;
+static uint8_t EchoRanger_Edges;
+static __vo uint8_t EchoRanger_Armed;
+static __vo uint16_t EchoRanger_Distance;
+static __vo uint32_t EchoRanger_Timestamp;
+static __vo uint8_t EchoRanger_Status;
+
+static void EchoRanger_Publish(uint32_t PulseUs);
+
+/**
+  * @brief  Configures the timer with TRIG held low. Measurements are started with
+  *         EchoRanger_Trigger(), the rest runs in hardware and in the capture interrupt.
+  * @retval None
+  */
+void EchoRanger_Init(void){
+  EchoRanger_hTIM.pTIMx = ECHORANGER_TIM;
+  EchoRanger_hTIM.Init.CounterMode = TIM_COUNTERMODE_UP;
+  EchoRanger_hTIM.Init.Prescaler = (TIM_GetClockFreq(ECHORANGER_TIM) / ECHORANGER_CLOCK_HZ) - 1;
+  EchoRanger_hTIM.Init.Period = (ECHORANGER_CYCLE_MS * (ECHORANGER_CLOCK_HZ / 1000)) - 1;
+
+  EchoRanger_Edges = 0;
+  EchoRanger_Armed = 0;
+  EchoRanger_Distance = 0;
+  EchoRanger_Timestamp = 0;
+  EchoRanger_Status = ECHORANGER_STATUS_NONE;
+
+  //TRIG idles low, the compare value marks the end of the trigger pulse
+  TIM_OC_Init(&EchoRanger_hTIM, ECHORANGER_TRIG_CHANNEL, TIM_OCMODE_FORCE_LOW,
+	      ECHORANGER_TRIG_US * (ECHORANGER_CLOCK_HZ / 1000000));
+  TIM_SetOCPreload(ECHORANGER_TIM, ECHORANGER_TRIG_CHANNEL, DISABLE);
+  TIM_IC_Init(&EchoRanger_hTIM, ECHORANGER_ECHO_CHANNEL, TIM_ICPOLARITY_BOTHEDGE);
+
+  //A software update (trigger) restarts the window without raising UIF
+  ECHORANGER_TIM->CR1 |= TIM_CR1_URS;
+
+  TIM_ITConfig(ECHORANGER_TIM, TIM_DIER_CC4IE | TIM_DIER_UIE, ENABLE);
+  TIM_IRQPriorityConfig(ECHORANGER_IRQ, ECHORANGER_IRQ_PRIORITY);
+  TIM_IRQInterruptConfig(ECHORANGER_IRQ, ENABLE);
+}
+
+/**
+  * @brief  Starts one measurement window. TRIG is raised with the counter stopped, the
+  *         counter is then restarted from 0 and the compare match drops TRIG
+  *         ECHORANGER_TRIG_US later. The pulse is never shorter than ECHORANGER_TRIG_US
+  *         and only longer by the few instructions between raising TRIG and the restart,
+  *         which run with interrupts masked.
+  * @retval None
+  */
+void EchoRanger_Trigger(void){
+  uint32_t primask;
+
+  TIM_ITConfig(ECHORANGER_TIM, TIM_DIER_CC4IE | TIM_DIER_UIE, DISABLE);
+
+  __asm volatile ("mrs %0, primask" : "=r" (primask));
+  __asm volatile ("cpsid i" ::: "memory");
+
+  //Stopped counter: no compare match can drop TRIG before the restart
+  ECHORANGER_TIM->CR1 &= ~TIM_CR1_CEN;
+  TIM_SetOCMode(ECHORANGER_TIM, ECHORANGER_TRIG_CHANNEL, TIM_OCMODE_FORCE_HIGH);
+  //Level held until the match
+  TIM_SetOCMode(ECHORANGER_TIM, ECHORANGER_TRIG_CHANNEL, TIM_OCMODE_INACTIVE);
+  ECHORANGER_TIM->EGR = TIM_EGR_UG;
+  ECHORANGER_TIM->CR1 |= TIM_CR1_CEN;
+
+  if(!primask){
+      __asm volatile ("cpsie i" ::: "memory");
+  }
+
+  ECHORANGER_TIM->SR = ~(TIM_SR_CC4IF | TIM_SR_CC4OF);
+  EchoRanger_Edges = 0;
+  EchoRanger_Armed = 1;
+
+  TIM_ITConfig(ECHORANGER_TIM, TIM_DIER_CC4IE | TIM_DIER_UIE, ENABLE);
+}
+
+/**
+  * @brief  Tells whether a measurement window is still open.
+  * @retval 1 while waiting for the echo, 0 otherwise.
+  */
+uint8_t EchoRanger_IsBusy(void){
+  return EchoRanger_Armed;
+}
+
+/**
+  * @brief  Returns the last valid distance.
+  * @retval Distance in mm, 0 before the first valid echo.
+  */
+uint16_t EchoRanger_GetDistance(void){
+  return EchoRanger_Distance;
+}
+
+/**
+  * @brief  Returns the time the last measurement cycle completed.
+  * @retval getTick() value in ms, 0 before the first measurement.
+  */
+uint32_t EchoRanger_GetTimestamp(void){
+  return EchoRanger_Timestamp;
+}
+
+/**
+  * @brief  Returns the result of the last measurement cycle.
+  * @retval Value of @ref ECHORANGER_STATUS_NONE. On ECHORANGER_STATUS_OUT_OF_RANGE the
+  *         distance keeps the previous value.
+  */
+uint8_t EchoRanger_GetStatus(void){
+  return EchoRanger_Status;
+}
+
+
+/**
+  * @brief  Converts an echo pulse width and publishes the measurement.
+  * @param  PulseUs: Echo pulse width in us, 0 if no complete echo was seen.
+  */
+static void EchoRanger_Publish(uint32_t PulseUs){
+  uint32_t distance = PulseUs * ECHORANGER_MM_PER_US_NUM / ECHORANGER_MM_PER_US_DEN;
+
+  if(PulseUs == 0 || distance < ECHORANGER_DISTANCE_MIN || distance > ECHORANGER_DISTANCE_MAX){
+      EchoRanger_Status = ECHORANGER_STATUS_OUT_OF_RANGE;
+  }
+  else{
+      EchoRanger_Distance = (uint16_t)distance;
+      EchoRanger_Status = ECHORANGER_STATUS_VALID;
+  }
+  EchoRanger_Timestamp = getTick();
+}
+
+/**
+  * @brief  Echo capture and window interrupt.
+  *
+  * The window starts with the trigger, so the first echo edge is the rising one and the
+  * second the falling one. A window that ends before the falling edge had no usable echo.
+  */
+void TIM5_IRQHandler(void){
+  uint32_t sr = ECHORANGER_TIM->SR;
+  uint32_t handled = 0;
+
+  //Captures first: a falling edge just before the wrap belongs to the ending window
+  if(sr & TIM_SR_CC4IF){
+      //Reading CCR4 clears CC4IF
+      uint32_t capture = TIM_GetCompare(&EchoRanger_hTIM, ECHORANGER_ECHO_CHANNEL);
+
+      if(EchoRanger_Armed){
+	  if(EchoRanger_Edges == 0){
+	      EchoRanger_RiseCapture = capture;
+	      EchoRanger_Edges = 1;
+	  }
+	  else{
+	      EchoRanger_Publish(capture - EchoRanger_RiseCapture);
+	      EchoRanger_Armed = 0;
+	  }
+      }
+  }
+
+  if(sr & TIM_SR_UIF){
+      handled |= TIM_SR_UIF;
+      if(EchoRanger_Armed){
+	  EchoRanger_Publish(0);
+	  EchoRanger_Armed = 0;
+      }
+  }
+
+  //An overcapture only means an edge was missed
+  handled |= sr & TIM_SR_CC4OF;
+
+  //Only the flags seen above: one set after the read is serviced by the next interrupt
+  ECHORANGER_TIM->SR = ~handled;
+}
@@ -0,0 +1,237 @@
+/*
+ * Encoder.c
+ *
+ *  Created on: Jul 2, 2025
+ *      Author: quanvm198
+ */
+
+#include "Encoder.h"
+#include <stdlib.h>
+
+#define ENCODER_TWO_PI				6.28318531f
+#define ENCODER_RAD_PER_COUNT		(ENCODER_TWO_PI / ENCODER_COUNTS_PER_REV)
+#define ENCODER_RAD_PER_LINE		(ENCODER_TWO_PI / ENCODER_LINES_PER_REV)
+#define ENCODER_M_PER_COUNT			(ENCODER_RAD_PER_COUNT * ENCODER_WHEEL_RADIUS_M)
+#define ENCODER_TIMEOUT_TICKS		((uint32_t)ENCODER_T_TIMEOUT_US * (ENCODER_CAPTURE_CLOCK_HZ / 1000000))
+
+static Encoder_Wheel_t Encoder_Wheels[2];
+static TIM_HandleTypeDef Encoder_hCaptureTIM;
+
+static void Encoder_InitWheel(Encoder_Wheel_t *pWheel, TIM_RegDef_t *TIMx, int8_t Sign);
+static void Encoder_UpdateWheel(Encoder_Wheel_t *pWheel);
+static uint32_t Encoder_TakeCapture(Encoder_Wheel_t *pWheel);
+static void Encoder_CaptureIRQ(Encoder_Wheel_t *pWheel, uint16_t Capture, uint8_t Overcapture);
+
+/**
+  * @brief  Starts both quadrature counters and the phase A capture timer.
+  * @retval None
+  */
+void Encoder_Init(void){
+  Encoder_InitWheel(&Encoder_Wheels[ENCODER_LEFT], ENCODER_LEFT_TIM, ENCODER_LEFT_SIGN);
+  Encoder_InitWheel(&Encoder_Wheels[ENCODER_RIGHT], ENCODER_RIGHT_TIM, ENCODER_RIGHT_SIGN);
+
+  //Free running timestamp timer for the T method
+  Encoder_hCaptureTIM.pTIMx = ENCODER_CAPTURE_TIM;
+  Encoder_hCaptureTIM.Init.CounterMode = TIM_COUNTERMODE_UP;
+  Encoder_hCaptureTIM.Init.Prescaler = (TIM_GetClockFreq(ENCODER_CAPTURE_TIM) / ENCODER_CAPTURE_CLOCK_HZ) - 1;
+  Encoder_hCaptureTIM.Init.Period = TIM_ARR_MAX_16BIT;
+
+  TIM_IC_Init(&Encoder_hCaptureTIM, ENCODER_LEFT_CAPTURE_CHANNEL, TIM_ICPOLARITY_RISING);
+  TIM_IC_Init(&Encoder_hCaptureTIM, ENCODER_RIGHT_CAPTURE_CHANNEL, TIM_ICPOLARITY_RISING);
+
+  TIM_ITConfig(ENCODER_CAPTURE_TIM, TIM_DIER_CC1IE | TIM_DIER_CC2IE, ENABLE);
+  TIM_IRQPriorityConfig(ENCODER_CAPTURE_IRQ, ENCODER_CAPTURE_IRQ_PRIORITY);
+  TIM_IRQInterruptConfig(ENCODER_CAPTURE_IRQ, ENABLE);
+}
+
+/**
+  * @brief  Samples both wheels, must be called every ENCODER_SAMPLE_PERIOD_MS.
+  *
+  * Above ENCODER_MT_SWITCH_COUNTS counts per sample the speed comes from the counter
+  * difference (M method). Below it too few counts arrive per sample for a usable
+  * resolution, so the speed is taken from the last phase A period (T method).
+  *
+  * @retval None
+  */
+void Encoder_Update(void){
+  Encoder_UpdateWheel(&Encoder_Wheels[ENCODER_LEFT]);
+  Encoder_UpdateWheel(&Encoder_Wheels[ENCODER_RIGHT]);
+}
+
+/**
+  * @brief  Returns the filtered wheel speed.
+  * @param  Wheel: ENCODER_LEFT or ENCODER_RIGHT
+  * @retval Speed in rad/s, forward positive
+  */
+float Encoder_GetSpeed(_Bool Wheel){
+  return Encoder_Wheels[Wheel].Speed;
+}
+
+/**
+  * @brief  Returns the distance travelled by a wheel since init or the last reset.
+  * @param  Wheel: ENCODER_LEFT or ENCODER_RIGHT
+  * @retval Distance in m, forward positive
+  */
+float Encoder_GetDistance(_Bool Wheel){
+  return Encoder_Wheels[Wheel].Distance;
+}
+
+/**
+  * @brief  Returns the method used for the last speed sample of a wheel.
+  * @param  Wheel: ENCODER_LEFT or ENCODER_RIGHT
+  * @retval ENCODER_METHOD_M or ENCODER_METHOD_T
+  */
+uint8_t Encoder_GetMethod(_Bool Wheel){
+  return Encoder_Wheels[Wheel].Method;
+}
+
+/**
+  * @brief  Clears the accumulated distance of both wheels.
+  * @retval None
+  */
+void Encoder_Reset(void){
+  for(uint8_t i = 0; i < 2; i++){
+      Encoder_Wheels[i].Position = 0;
+      Encoder_Wheels[i].Distance = 0.0f;
+  }
+}
+
+
+/**
+  * @brief  Configures one quadrature counter and clears its state.
+  */
+static void Encoder_InitWheel(Encoder_Wheel_t *pWheel, TIM_RegDef_t *TIMx, int8_t Sign){
+  pWheel->hTIM.pTIMx = TIMx;
+  pWheel->hTIM.Init.CounterMode = TIM_COUNTERMODE_UP;
+  pWheel->hTIM.Init.Prescaler = 0;
+  pWheel->hTIM.Init.Period = TIM_ARR_MAX_16BIT;
+  TIM_Encoder_Init(&pWheel->hTIM);
+
+  pWheel->Sign = Sign;
+  pWheel->LastCount = (uint16_t)TIM_GetCounter(&pWheel->hTIM);
+  pWheel->Position = 0;
+  pWheel->Stale = 1;
+  pWheel->ValidPeriod = 0;
+  pWheel->SinceEdge = ENCODER_TIMEOUT_TICKS;
+  pWheel->Method = ENCODER_METHOD_T;
+  pWheel->Speed = 0.0f;
+  pWheel->Distance = 0.0f;
+}
+
+/**
+  * @brief  Speed and distance update of one wheel.
+  * @param  pWheel: Wheel state
+  */
+static void Encoder_UpdateWheel(Encoder_Wheel_t *pWheel){
+  float rawSpeed = 0.0f;
+
+  //16-bit difference handles counter wrap in both directions
+  uint16_t count = (uint16_t)TIM_GetCounter(&pWheel->hTIM);
+  int16_t delta = (int16_t)(count - pWheel->LastCount) * pWheel->Sign;
+  pWheel->LastCount = count;
+  pWheel->Position += delta;
+  pWheel->Distance = pWheel->Position * ENCODER_M_PER_COUNT;
+
+  //Edges are tracked every sample so that the T method is ready when the speed drops
+  uint32_t period = Encoder_TakeCapture(pWheel);
+
+  if(abs(delta) >= ENCODER_MT_SWITCH_COUNTS){
+      pWheel->Method = ENCODER_METHOD_M;
+      rawSpeed = delta * (ENCODER_RAD_PER_COUNT * 1000.0f / ENCODER_SAMPLE_PERIOD_MS);
+  }
+  else{
+      pWheel->Method = ENCODER_METHOD_T;
+      if(period){
+	  //Counter direction bit gives the sign, the encoder timer sets it from the A/B phase order
+	  int8_t dir = (pWheel->hTIM.pTIMx->CR1 & TIM_CR1_DIR) ? -pWheel->Sign : pWheel->Sign;
+	  rawSpeed = dir * (ENCODER_RAD_PER_LINE * ENCODER_CAPTURE_CLOCK_HZ) / (float)period;
+      }
+  }
+
+  pWheel->Speed += ENCODER_SPEED_FILTER_ALPHA * (rawSpeed - pWheel->Speed);
+}
+
+/**
+  * @brief  Consumes the edges captured since the previous sample.
+  * @param  pWheel: Wheel state
+  * @retval Period in capture ticks to use for the T method, 0 if the wheel is considered stopped.
+  *         While no new edge arrives the period is stretched to the time since the last edge,
+  *         so the estimate decays towards zero instead of holding the last value.
+  */
+static uint32_t Encoder_TakeCapture(Encoder_Wheel_t *pWheel){
+  uint8_t seq;
+  uint16_t period, lastCapture, now;
+
+  //Consistent snapshot of the ISR fields. The counter is read after LastCapture, so an
+  //edge landing in between restarts the loop instead of putting now behind lastCapture.
+  do{
+      seq = pWheel->CaptureSeq;
+      period = pWheel->Period;
+      lastCapture = pWheel->LastCapture;
+      now = (uint16_t)TIM_GetCounter(&Encoder_hCaptureTIM);
+  }while(seq != pWheel->CaptureSeq);
+
+  uint8_t newEdges = (uint8_t)(seq - pWheel->SeenSeq);
+  pWheel->SeenSeq = seq;
+
+  if(newEdges){
+      //After a timeout the first period spans an unknown number of timer wraps,
+      //a period of 0 spans a missed edge: keep the last trusted one in both cases
+      if((!pWheel->Stale || newEdges >= 2) && period != 0){
+	  pWheel->ValidPeriod = period;
+      }
+      pWheel->Stale = 0;
+  }
+
+  if(pWheel->Stale){
+      return 0;
+  }
+
+  //Sampled well within the 16-bit wrap, so the difference is unambiguous
+  pWheel->SinceEdge = (uint16_t)(now - lastCapture);
+  if(pWheel->SinceEdge >= ENCODER_TIMEOUT_TICKS){
+      pWheel->Stale = 1;
+      pWheel->ValidPeriod = 0;
+      return 0;
+  }
+
+  if(pWheel->ValidPeriod == 0){
+      return 0;
+  }
+
+  return (pWheel->SinceEdge > pWheel->ValidPeriod) ? pWheel->SinceEdge : pWheel->ValidPeriod;
+}
+
+/**
+  * @brief  Records one phase A edge.
+  * @param  pWheel: Wheel state
+  * @param  Capture: Captured timer value
+  * @param  Overcapture: An edge was lost before Capture, the period spans two edges
+  */
+static void Encoder_CaptureIRQ(Encoder_Wheel_t *pWheel, uint16_t Capture, uint8_t Overcapture){
+  pWheel->Period = Overcapture ? 0 : (uint16_t)(Capture - pWheel->LastCapture);
+  pWheel->LastCapture = Capture;
+  pWheel->CaptureSeq++;
+}
+
+/**
+  * @brief  Phase A capture interrupt (TIM9 shares its vector with TIM1 break).
+  */
+void TIM1_BRK_TIM9_IRQHandler(void){
+  uint32_t sr = ENCODER_CAPTURE_TIM->SR;
+  uint32_t handled = sr & (TIM_SR_CC1OF | TIM_SR_CC2OF);
+
+  //Reading CCRx clears CCxIF. An overcapture means an edge was missed, so the period
+  //ending at this capture covers two edges and is discarded.
+  if(sr & TIM_SR_CC1IF){
+      Encoder_CaptureIRQ(&Encoder_Wheels[ENCODER_LEFT], (uint16_t)TIM_GetCompare(&Encoder_hCaptureTIM, ENCODER_LEFT_CAPTURE_CHANNEL),
+			 (sr & TIM_SR_CC1OF) != 0);
+  }
+  if(sr & TIM_SR_CC2IF){
+      Encoder_CaptureIRQ(&Encoder_Wheels[ENCODER_RIGHT], (uint16_t)TIM_GetCompare(&Encoder_hCaptureTIM, ENCODER_RIGHT_CAPTURE_CHANNEL),
+			 (sr & TIM_SR_CC2OF) != 0);
+  }
+
+  //Only the overcapture flags seen above, a later one is left for the next interrupt
+  ENCODER_CAPTURE_TIM->SR = ~handled;
+}
@@ -5,10 +5,84 @@
  *      Author: quanvm198
  */
 #include "MAX7219.h"
+#include "DisplayNumber.h"
+
+//Shadow of the digit registers, bit n of the mask set when row n differs on any module
+static uint8_t MAX7219_FrameBuffer[MAX7219_MODULE_COUNT][MAX7219_DIGIT_COUNT];
+static uint8_t MAX7219_DirtyMask;
+
+//SPI frames of all rows, one contiguous buffer: the last module's command goes out first
+static uint8_t MAX7219_TxFrame[MAX7219_DIGIT_COUNT][MAX7219_ROW_BYTES];
+
+//DMA refresh
+static SPI_HandleTypeDef MAX7219_hSPI;
+static DMA_HandleTypeDef MAX7219_hDMA;
+static _Bool MAX7219_DMAEnabled;
+static __vo uint8_t MAX7219_TxRows;		//Rows still to send
+static __vo _Bool MAX7219_TxBusy;
+static uint8_t MAX7219_TxRow;			//Row on the wire
+static __vo uint8_t MAX7219_TxFailed;	//Rows to send again, written only while busy
+
+static void MAX7219_Write(SPI_RegDef_t* SPIx, uint8_t Address, uint8_t Data);
+static void MAX7219_SendRow(SPI_RegDef_t* SPIx, const uint8_t* pData);
+static void MAX7219_BuildRow(uint8_t Row);
+static void MAX7219_StartNextRow(void);
+static void MAX7219_RowSent(SPI_HandleTypeDef *hspi);
+static void MAX7219_RowError(SPI_HandleTypeDef *hspi);
+static void MAX7219_AbortRefresh(void);
+
+/*
+ * Keyframe tables of the signal animations (digit 0 is the leftmost arrow head)
+ */
+static const MAX7219_Keyframe_t MAX7219_LeftSignalFrames[] =
+{
+	{ { 0x06, 0x00, 0x00, 0x00 },  MAX7219_ANIM_FRAME_MS },
+	{ { 0x06, 0x01, 0x00, 0x00 },  MAX7219_ANIM_FRAME_MS },
+	{ { 0x06, 0x01, 0x01, 0x00 },  MAX7219_ANIM_FRAME_MS },
+	{ { 0x06, 0x01, 0x01, 0x01 }, 250 },
+	{ { 0x00, 0x00, 0x00, 0x00 }, 200 },
+};
+
+static const MAX7219_Keyframe_t MAX7219_RightSignalFrames[] =
+{
+	{ { 0, 0, 0, 0, 0x01, 0x00, 0x00, 0x00 },  MAX7219_ANIM_FRAME_MS },
+	{ { 0, 0, 0, 0, 0x01, 0x01, 0x00, 0x00 },  MAX7219_ANIM_FRAME_MS },
+	{ { 0, 0, 0, 0, 0x01, 0x01, 0x01, 0x00 },  MAX7219_ANIM_FRAME_MS },
+	{ { 0, 0, 0, 0, 0x01, 0x01, 0x01, 0x30 }, 250 },
+	{ { 0, 0, 0, 0, 0x00, 0x00, 0x00, 0x00 }, 200 },
+};
+
+static const MAX7219_Keyframe_t MAX7219_StopSignalFrames[] =
+{
+	{ { 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00 },  MAX7219_ANIM_FRAME_MS },
+	{ { 0x00, 0x00, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00 },  MAX7219_ANIM_FRAME_MS },
+	{ { 0x00, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00 },  MAX7219_ANIM_FRAME_MS },
+	{ { 0x06, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x30 }, 250 },
+	{ { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }, 200 },
+};
+
+const MAX7219_Animation_t MAX7219_AnimLeftSignal =
+	{ MAX7219_LeftSignalFrames, sizeof(MAX7219_LeftSignalFrames) / sizeof(MAX7219_LeftSignalFrames[0]), 0x0F };
+const MAX7219_Animation_t MAX7219_AnimRightSignal =
+	{ MAX7219_RightSignalFrames, sizeof(MAX7219_RightSignalFrames) / sizeof(MAX7219_RightSignalFrames[0]), 0xF0 };
+const MAX7219_Animation_t MAX7219_AnimStopSignal =
+	{ MAX7219_StopSignalFrames, sizeof(MAX7219_StopSignalFrames) / sizeof(MAX7219_StopSignalFrames[0]), 0xFF };
+
+//Animation player state
+static struct
+{
+	const MAX7219_Animation_t	*pCurrent;		//NULL when idle
+	const MAX7219_Animation_t	*pNext;			//Chained animation, NULL if none
+	uint32_t					FrameStart;		//getTick() when the current keyframe was due
+	uint8_t						Frame;
+	_Bool						Loop;
+	_Bool						NextLoop;
+	_Bool						Pending;		//First keyframe not shown yet
+}MAX7219_Anim;
 
 
 /**
-  * @brief  Sends a command (address and data) to the MAX7219 via SPI.
+  * @brief  Sends a command (address and data) to every MAX7219 of the chain via SPI.
   * @param  SPIx: Pointer to the SPI peripheral configuration structure.
   * @param  Address: Register address in MAX7219.
   * @param  Data: Data to be sent to the specified address.
@@ -16,9 +90,15 @@
   */
 
 void MAX7219_SendCommand(SPI_RegDef_t* SPIx, uint8_t Address, uint8_t Data){
-  uint8_t TX_Data[2] = {Address, Data};
+  MAX7219_Write(SPIx, Address, Data);
 
-  SPI_Transmit(SPIx, TX_Data, 2);
+  //Keep the shadow in sync when a digit is written directly (all modules get the command)
+  if(Address >= MAX7219_REG_DIGIT0 && Address <= MAX7219_REG_DIGIT7){
+      for(uint8_t module = 0; module < MAX7219_MODULE_COUNT; module++){
+	  MAX7219_FrameBuffer[module][Address - MAX7219_REG_DIGIT0] = Data;
+      }
+      MAX7219_DirtyMask &= ~(1 << (Address - MAX7219_REG_DIGIT0));
+  }
 }
 
 /**
@@ -63,6 +143,8 @@ void MAX7219_SetScanLimit(SPI_RegDef_t* SPIx, uint8_t ScanLimit){
 
 /**
   * @brief  Initializes the MAX7219 display with basic configurations.
+  * @note   SPIx must already be configured as an 8-bit master (SPI_Initialize). The chip
+  *         select is taken over by software and SPI is left enabled.
   * @param  SPIx: Pointer to the SPI peripheral configuration structure.
   * @param  DecodeMode: Decode mode configuration.
   * @param  IntensityLevel: Brightness level.
@@ -70,22 +152,133 @@ void MAX7219_SetScanLimit(SPI_RegDef_t* SPIx, uint8_t ScanLimit){
   * @retval None
   */
 void MAX7219_Init(SPI_RegDef_t* SPIx, uint8_t DecodeMode, uint8_t IntensityLevel, uint8_t ScanLimit){
-  MAX7219_Clean(SPIx);
-  MAX7219_OperationMode(SPIx, MAX7219_NORMAL_OPERATION);
+  //CS as a plain output, idle high
+  GPIO_Initialize(MAX7219_CS_PORT, MAX7219_CS_PIN, GPIO_MODE_OUTPUT);
+  GPIO_SetPinFast(MAX7219_CS_PORT, MAX7219_CS_PIN);
+
+  //Software NSS: SSM = SSI = 1 keeps the master out of mode fault with the pin released
+  SPI_PeripheralControl(SPIx, DISABLE);
+  SPI_SSOEConfig(SPIx, DISABLE);
+  SPIx->CR1 |= (1 << SPI_CR1_SSM);
+  SPI_SSIConfig(SPIx, ENABLE);
+  SPI_PeripheralControl(SPIx, ENABLE);
+
+  MAX7219_TestLED(SPIx, 0);
   MAX7219_SetDecodeMode(SPIx, DecodeMode);
   MAX7219_SetIntensity(SPIx, IntensityLevel);
   MAX7219_SetScanLimit(SPIx, ScanLimit);
+  MAX7219_Clean(SPIx);
+  MAX7219_OperationMode(SPIx, MAX7219_NORMAL_OPERATION);
 }
 
 /**
-  * @brief  Displays a value on a specific digit of the MAX7219.
-  * @param  SPIx: Pointer to the SPI peripheral configuration structure.
+  * @brief  Sets the value of a digit of module 0 in the framebuffer, MAX7219_Flush() sends it.
+  * @param  SPIx: Pointer to the SPI peripheral configuration structure (unused, the
+  *         write only touches the framebuffer).
   * @param  Digit: Digit register (0x01 to 0x08).
   * @param  Value: Value to be displayed on the digit.
   * @retval None
   */
 void MAX7219_SetDigitValue(SPI_RegDef_t* SPIx, uint8_t Digit, uint8_t Value){
-  MAX7219_SendCommand(SPIx, Digit, Value);
+  MAX7219_SetModuleDigit(0, Digit, Value);
+}
+
+/**
+  * @brief  Sets the value of a digit of one module in the framebuffer.
+  * @param  Module: Position in the chain (0 is wired to the MCU).
+  * @param  Digit: Digit register (0x01 to 0x08).
+  * @param  Value: Value to be displayed on the digit.
+  * @retval None
+  */
+void MAX7219_SetModuleDigit(uint8_t Module, uint8_t Digit, uint8_t Value){
+  if(Module >= MAX7219_MODULE_COUNT || Digit < MAX7219_REG_DIGIT0 || Digit > MAX7219_REG_DIGIT7){
+      return;
+  }
+
+  uint8_t index = Digit - MAX7219_REG_DIGIT0;
+  if(MAX7219_FrameBuffer[Module][index] != Value){
+      MAX7219_FrameBuffer[Module][index] = Value;
+      MAX7219_DirtyMask |= (1 << index);
+  }
+}
+
+/**
+  * @brief  Sends the rows changed since the last flush, nothing if none changed.
+  *         With DMA enabled the call only starts the refresh and returns. If a refresh
+  *         is still running, the changed rows stay pending for the next call.
+  * @param  SPIx: Pointer to the SPI peripheral configuration structure.
+  * @retval None
+  */
+void MAX7219_Flush(SPI_RegDef_t* SPIx){
+  if(MAX7219_TxBusy){
+      return;
+  }
+
+  //Rows lost by a failed refresh go out again
+  MAX7219_DirtyMask |= MAX7219_TxFailed;
+  MAX7219_TxFailed = 0;
+
+  if(!MAX7219_DirtyMask){
+      return;
+  }
+
+  uint8_t dirty = MAX7219_DirtyMask;
+  MAX7219_DirtyMask = 0;
+
+  for(uint8_t row = 0; row < MAX7219_DIGIT_COUNT; row++){
+      if(dirty & (1 << row)){
+	  MAX7219_BuildRow(row);
+      }
+  }
+
+  if(MAX7219_DMAEnabled){
+      MAX7219_TxRows = dirty;
+      MAX7219_TxBusy = 1;
+      MAX7219_StartNextRow();
+      return;
+  }
+
+  for(uint8_t row = 0; row < MAX7219_DIGIT_COUNT; row++){
+      if(dirty & (1 << row)){
+	  MAX7219_SendRow(SPIx, MAX7219_TxFrame[row]);
+      }
+  }
+}
+
+/**
+  * @brief  Moves the refresh of MAX7219_Flush() to DMA. Call after MAX7219_Init().
+  * @param  SPIx: Pointer to the SPI peripheral driving the chain (SPI1 for the stream allocation).
+  * @retval None
+  */
+void MAX7219_EnableDMA(SPI_RegDef_t* SPIx){
+  MAX7219_hDMA.Init.Direction = DMA_MEMORY_TO_PERIPH;
+  MAX7219_hDMA.Init.PeriphInc = DISABLE;
+  MAX7219_hDMA.Init.MemInc = ENABLE;
+  MAX7219_hDMA.Init.PeriphDataAlignment = DMA_DATA_BYTE;
+  MAX7219_hDMA.Init.MemDataAlignment = DMA_DATA_BYTE;
+  MAX7219_hDMA.Init.Mode = DMA_NORMAL;
+  MAX7219_hDMA.Init.Priority = DMA_PRIORITY_LOW;
+  MAX7219_hDMA.Init.FIFOMode = DISABLE;
+  MAX7219_hDMA.Init.DoubleBuffer = DISABLE;
+  DMA_Allocate(&MAX7219_hDMA, MAX7219_DMA_ALLOCATION);
+  if(DMA_Init(&MAX7219_hDMA) != DMA_OK){
+      return;
+  }
+
+  MAX7219_hSPI.pSPIx = SPIx;
+  MAX7219_hSPI.TxState = SPI_STATE_READY;
+  MAX7219_hSPI.hdmatx = &MAX7219_hDMA;
+  MAX7219_hSPI.TxCpltCallback = MAX7219_RowSent;
+  MAX7219_hSPI.TxErrorCallback = MAX7219_RowError;
+  MAX7219_DMAEnabled = 1;
+}
+
+/**
+  * @brief  Tells whether a DMA refresh is running.
+  * @retval 1 while rows are being sent, 0 otherwise.
+  */
+_Bool MAX7219_IsBusy(void){
+  return MAX7219_TxBusy;
 }
 
 /**
@@ -104,145 +297,278 @@ void MAX7219_TestLED(SPI_RegDef_t* SPIx, _Bool IsEnabled){
   * @retval None
   */
 void MAX7219_Clean(SPI_RegDef_t* SPIx){
-  for(int count = 0; count <= 0xC; count++){
-      MAX7219_SendCommand(SPIx, count, 0);
-  }
-  MAX7219_SendCommand(SPIx, 0xF, 0);
-}
-
-/**
-  * @brief  Calculates 10 raised to the power of x.
-  * @param  x: The exponent value.
-  * @retval 10^x as an unsigned 32-bit integer.
-  */
-uint32_t POWER_10(uint8_t x){
-  double result = 1;
-  while (x--) {
-      result *= 10;
+  //Every digit is resent, the chip content is unknown after power up
+  for(uint8_t module = 0; module < MAX7219_MODULE_COUNT; module++){
+      for(uint8_t index = 0; index < MAX7219_DIGIT_COUNT; index++){
+	  MAX7219_FrameBuffer[module][index] = 0;
+      }
   }
-  return result;
+  MAX7219_DirtyMask = 0xFF;
+  MAX7219_Flush(SPIx);
 }
 
 /**
-  * @brief  Displays a number starting from a specific position on the MAX7219.
-  * @param  SPIx: Pointer to the SPI peripheral configuration structure.
-  * @param  Position: Starting digit position (1 to 8).
+  * @brief  Writes a number into the framebuffer starting from a specific position,
+  *         MAX7219_Flush() sends it. The digits must use Code B decode.
+  * @param  SPIx: Pointer to the SPI peripheral configuration structure (unused).
+  * @param  Position: Starting digit position (1 to 8), least significant digit.
   * @param  Number: The number to be displayed.
   * @param  NoOfLEDDigits: Number of digits to be shown (padding with zero if needed).
+  *         A number that does not fit is shown as dashes.
   * @retval None
   */
 void MAX7219_DisplayNumbers(SPI_RegDef_t* SPIx, uint8_t Position, uint32_t Number, uint8_t NoOfLEDDigits){
-//  //Get number of digits of the number
-//  uint8_t NumberOfDigits = 0;
-//  uint32_t Temp_Number = Number;
-//  while(Temp_Number >= 0){
-//      NumberOfDigits += 1;
-//      Temp_Number /= 10;
-//      if(!Temp_Number) break;
-//  }
-//
-//  //Display each numeber's digit
-//  uint32_t Pow_Number = POWER_10(NumberOfDigits - 1);
-//  Temp_Number = Number;
-//  uint8_t digit = 0;
-//
-//  while(Pow_Number){
-//      digit = Temp_Number / Pow_Number;  //Get 1st digit in the temporary number
-//      MAX7219_SendCommand(SPIx, StartDigit, digit); //Display the digit in desired position
-//      StartDigit--;  //Update the next position to display
-//      Temp_Number %= Pow_Number;  //Get the number's next digit
-//      Pow_Number /= 10;
-//  }
-
-  uint32_t Temp_Number = Number;
-  uint8_t Expected_EndPosition = Position + NoOfLEDDigits - 1;
-
-
-  while(Temp_Number){
-      MAX7219_SendCommand(SPIx, Position, Temp_Number % 10);
-      Temp_Number /= 10;
-      Position ++;
-  }
-
-  while(Position <= Expected_EndPosition){
-      MAX7219_SendCommand(SPIx, Position, 0);
-      Position++;
-  }
-}
-
-/**
-  * @brief  Displays a left turn signal animation on the MAX7219 display.
-  * @param  SPIx: Pointer to the SPI peripheral configuration structure.
+  //Anything above INT32_MAX overflows the 8 digits anyway
+  int32_t value = (Number > 0x7FFFFFFFU) ? 0x7FFFFFFF : (int32_t)Number;
+
+  DisplayNumber_Show(Position, NoOfLEDDigits, value, 0, DISPLAYNUMBER_FLAG_ZERO_PAD);
+}
+
+/**
+  * @brief  Starts the left turn signal animation, MAX7219_Anim_Update() plays it.
+  * @param  SPIx: Pointer to the SPI peripheral configuration structure (unused).
   * @retval None
   */
 void MAX7219_LeftSignal(SPI_RegDef_t* SPIx){
-  for(uint8_t digit = MAX7219_REG_DIGIT0; digit <= MAX7219_REG_DIGIT3; digit++){
-      if(digit == MAX7219_REG_DIGIT0){
-	  MAX7219_SetDigitValue(SPIx, digit, 0x6);
-      }
-      else{
-      MAX7219_SetDigitValue(SPIx, digit, 0x1);
-      }
-      Delay_ms(50); }
-  Delay_ms(200);
+  MAX7219_Anim_Play(&MAX7219_AnimLeftSignal, 0);
+}
 
-  for(uint8_t digit = MAX7219_REG_DIGIT0; digit <= MAX7219_REG_DIGIT3; digit++){
-      MAX7219_SetDigitValue(SPIx, digit, 0x0);
+/**
+  * @brief  Starts the right turn signal animation, MAX7219_Anim_Update() plays it.
+  * @param  SPIx: Pointer to the SPI peripheral configuration structure (unused).
+  * @retval None
+  */
+void MAX7219_RightSignal(SPI_RegDef_t* SPIx){
+  MAX7219_Anim_Play(&MAX7219_AnimRightSignal, 0);
+}
+
+/**
+  * @brief  Starts the stop signal animation (blinking inward from the outer digits),
+  *         MAX7219_Anim_Update() plays it.
+  * @param  SPIx: Pointer to the SPI peripheral configuration structure (unused).
+  * @retval None
+  */
+void MAX7219_StopSignal(SPI_RegDef_t* SPIx){
+  MAX7219_Anim_Play(&MAX7219_AnimStopSignal, 0);
+}
+
+/**
+  * @brief  Starts an animation now, replacing the current one and any chained one.
+  * @param  pAnim: Animation to play.
+  * @param  Loop: 1 to repeat it until stopped or a chained animation takes over.
+  * @retval None
+  */
+void MAX7219_Anim_Play(const MAX7219_Animation_t* pAnim, _Bool Loop){
+  MAX7219_Anim.pCurrent = pAnim;
+  MAX7219_Anim.Loop = Loop;
+  MAX7219_Anim.pNext = NULL;
+  MAX7219_Anim.Frame = 0;
+  MAX7219_Anim.FrameStart = getTick();
+  MAX7219_Anim.Pending = 1;
+}
+
+/**
+  * @brief  Queues an animation to start when the current one completes its cycle.
+  *         Starts it immediately if nothing is playing.
+  * @param  pAnim: Animation to play next.
+  * @param  Loop: 1 to repeat it.
+  * @retval None
+  */
+void MAX7219_Anim_Chain(const MAX7219_Animation_t* pAnim, _Bool Loop){
+  if(MAX7219_Anim.pCurrent == NULL){
+      MAX7219_Anim_Play(pAnim, Loop);
+      return;
   }
-  Delay_ms(200);
+  MAX7219_Anim.pNext = pAnim;
+  MAX7219_Anim.NextLoop = Loop;
 }
 
 /**
-  * @brief  Displays a right turn signal animation on the MAX7219 display.
-  * @param  SPIx: Pointer to the SPI peripheral configuration structure.
+  * @brief  Stops the animations, the digits keep their current content.
   * @retval None
   */
-void MAX7219_RightSignal(SPI_RegDef_t* SPIx){
-  for(uint8_t digit = MAX7219_REG_DIGIT4; digit <= MAX7219_REG_DIGIT7; digit++){
-      if(digit == MAX7219_REG_DIGIT7){
-	  MAX7219_SetDigitValue(SPIx, digit, 0x30);
+void MAX7219_Anim_Stop(void){
+  MAX7219_Anim.pCurrent = NULL;
+  MAX7219_Anim.pNext = NULL;
+}
+
+/**
+  * @brief  Advances the animation player, called from the main loop.
+  *         Does at most one keyframe per call and never waits.
+  * @retval 1 if the framebuffer was changed (MAX7219_Flush() needed), 0 otherwise.
+  */
+_Bool MAX7219_Anim_Update(void){
+  const MAX7219_Animation_t *pAnim = MAX7219_Anim.pCurrent;
+
+  if(pAnim == NULL){
+      return 0;
+  }
+
+  //A new animation shows its first keyframe straight away
+  if(!MAX7219_Anim.Pending){
+      uint32_t now = getTick();
+      if((uint32_t)(now - MAX7219_Anim.FrameStart) < pAnim->pFrames[MAX7219_Anim.Frame].DurationMs){
+	  return 0;
       }
-      else{
-      MAX7219_SetDigitValue(SPIx, digit, 0x1);
+      MAX7219_Anim.FrameStart += pAnim->pFrames[MAX7219_Anim.Frame].DurationMs;
+
+      if(++MAX7219_Anim.Frame >= pAnim->FrameCount){
+	  MAX7219_Anim.Frame = 0;
+	  if(MAX7219_Anim.pNext != NULL){
+	      pAnim = MAX7219_Anim.pNext;
+	      MAX7219_Anim.pCurrent = pAnim;
+	      MAX7219_Anim.Loop = MAX7219_Anim.NextLoop;
+	      MAX7219_Anim.pNext = NULL;
+	  }
+	  else if(!MAX7219_Anim.Loop){
+	      MAX7219_Anim.pCurrent = NULL;
+	      return 0;
+	  }
       }
-      Delay_ms(50);
   }
-  Delay_ms(200);
+  MAX7219_Anim.Pending = 0;
 
-  for(uint8_t digit = MAX7219_REG_DIGIT4; digit <= MAX7219_REG_DIGIT7; digit++){
-      MAX7219_SetDigitValue(SPIx, digit, 0x0);
+  const MAX7219_Keyframe_t *pFrame = &pAnim->pFrames[MAX7219_Anim.Frame];
+  for(uint8_t index = 0; index < MAX7219_DIGIT_COUNT; index++){
+      if(pAnim->DigitMask & (1 << index)){
+	  MAX7219_SetDigitValue(NULL, MAX7219_REG_DIGIT0 + index, pFrame->Digits[index]);
+      }
   }
-  Delay_ms(200);
+  return 1;
 }
 
 /**
-  * @brief  Displays a stop signal animation by blinking inward from the outer digits.
-  * @param  SPIx: Pointer to the SPI peripheral configuration structure.
-  * @retval None
+  * @brief  Tells whether an animation is playing.
+  * @retval 1 while playing, 0 once a non looping animation has finished.
   */
-void MAX7219_StopSignal(SPI_RegDef_t* SPIx){
-  uint8_t right = MAX7219_REG_DIGIT3;
-  uint8_t left = MAX7219_REG_DIGIT4;
-  while (right > 0)
-  {
-    if(right == MAX7219_REG_DIGIT0 || left == MAX7219_REG_DIGIT7){
-      MAX7219_SetDigitValue(SPIx, MAX7219_REG_DIGIT0, 0x6);
-      MAX7219_SetDigitValue(SPIx, MAX7219_REG_DIGIT7, 0x30);
-    }else {
-      MAX7219_SetDigitValue(SPIx, right, 0x1);
-      MAX7219_SetDigitValue(SPIx, left, 0x1);
-    }
-    Delay_ms(50);
-    right--;
-    left++;
+_Bool MAX7219_Anim_IsRunning(void){
+  return MAX7219_Anim.pCurrent != NULL;
+}
+
+/**
+  * @brief  Digits owned by the playing animation, other writers must leave them alone.
+  * @retval Bit n set: digit n belongs to the animation. 0 when idle.
+  */
+uint8_t MAX7219_Anim_GetDigitMask(void){
+  return (MAX7219_Anim.pCurrent != NULL) ? MAX7219_Anim.pCurrent->DigitMask : 0;
+}
+
+
+/**
+  * @brief  Sends the same command to every module of the chain (blocking).
+  * @param  SPIx: Pointer to the SPI peripheral, enabled in 8-bit master mode.
+  * @param  Address: Register address in MAX7219.
+  * @param  Data: Register value.
+  */
+static void MAX7219_Write(SPI_RegDef_t* SPIx, uint8_t Address, uint8_t Data){
+  uint8_t row[MAX7219_ROW_BYTES];
+
+  for(uint8_t module = 0; module < MAX7219_MODULE_COUNT; module++){
+      row[2 * module] = Address;
+      row[2 * module + 1] = Data;
   }
 
+  //Commands never interleave with a DMA refresh. A refresh that does not end is
+  //stopped, its rows are sent again by the next flush.
+  uint32_t start = getTick();
+  while(MAX7219_TxBusy){
+      if((uint32_t)(getTick() - start) > MAX7219_TX_TIMEOUT_MS){
+	  MAX7219_AbortRefresh();
+      }
+  }
+  MAX7219_SendRow(SPIx, row);
+}
+
+/**
+  * @brief  Sends one row frame (one command per module) framed by the software chip select.
+  * @param  SPIx: Pointer to the SPI peripheral, enabled in 8-bit master mode.
+  * @param  pData: MAX7219_ROW_BYTES bytes, last module first.
+  */
+static void MAX7219_SendRow(SPI_RegDef_t* SPIx, const uint8_t* pData){
+  GPIO_ResetPinFast(MAX7219_CS_PORT, MAX7219_CS_PIN);
+
+  for(uint8_t i = 0; i < MAX7219_ROW_BYTES; i++){
+      while(!SPI_GetFlagStatus(SPIx, SPI_FLAG_TXE));
+      SPIx->DR = pData[i];
+  }
+
+  //All bytes must be out before LOAD rises
+  while(!SPI_GetFlagStatus(SPIx, SPI_FLAG_TXE));
+  while(SPI_GetFlagStatus(SPIx, SPI_FLAG_BSY));
+
+  GPIO_SetPinFast(MAX7219_CS_PORT, MAX7219_CS_PIN);
+}
 
-  Delay_ms(200);
-  for(uint8_t digit = MAX7219_REG_DIGIT0; digit <= MAX7219_REG_DIGIT7; digit++){
-      MAX7219_SetDigitValue(SPIx, digit, 0x0);
-    }
-    Delay_ms(200);
+/**
+  * @brief  Builds the SPI frame of one row from the framebuffer.
+  * @param  Row: Digit index (0..7).
+  */
+static void MAX7219_BuildRow(uint8_t Row){
+  uint8_t *pFrame = MAX7219_TxFrame[Row];
+
+  //The first command shifted in ends up in the last module
+  for(uint8_t module = 0; module < MAX7219_MODULE_COUNT; module++){
+      uint8_t slot = MAX7219_MODULE_COUNT - 1 - module;
+      pFrame[2 * slot] = MAX7219_REG_DIGIT0 + Row;
+      pFrame[2 * slot + 1] = MAX7219_FrameBuffer[module][Row];
+  }
 }
 
+/**
+  * @brief  Starts the DMA transfer of the next pending row. If the stream does not
+  *         start the refresh ends here and the rows are kept for the next flush.
+  */
+static void MAX7219_StartNextRow(void){
+  uint8_t row = 0;
 
+  while(!(MAX7219_TxRows & (1 << row))){
+      row++;
+  }
+  MAX7219_TxRows &= ~(1 << row);
+  MAX7219_TxRow = row;
+
+  GPIO_ResetPinFast(MAX7219_CS_PORT, MAX7219_CS_PIN);
+  if(SPI_Transmit_DMA(&MAX7219_hSPI, MAX7219_TxFrame[row], MAX7219_ROW_BYTES) != SPI_STATE_READY){
+      MAX7219_RowError(&MAX7219_hSPI);
+  }
+}
+
+/**
+  * @brief  Row transfer complete (DMA interrupt): latches the row and chains the next one.
+  */
+static void MAX7219_RowSent(SPI_HandleTypeDef *hspi){
+  GPIO_SetPinFast(MAX7219_CS_PORT, MAX7219_CS_PIN);
+
+  if(MAX7219_TxRows){
+      MAX7219_StartNextRow();
+  }
+  else{
+      MAX7219_TxBusy = 0;
+  }
+}
+
+/**
+  * @brief  Row transfer failed: releases CS and ends the refresh, the row on the wire
+  *         and the ones not sent yet are retried by the next flush.
+  */
+static void MAX7219_RowError(SPI_HandleTypeDef *hspi){
+  GPIO_SetPinFast(MAX7219_CS_PORT, MAX7219_CS_PIN);
+
+  MAX7219_TxFailed |= MAX7219_TxRows | (1 << MAX7219_TxRow);
+  MAX7219_TxRows = 0;
+  MAX7219_TxBusy = 0;
+}
+
+/**
+  * @brief  Stops a refresh that did not complete (no DMA interrupt came).
+  */
+static void MAX7219_AbortRefresh(void){
+  DMA_Abort(&MAX7219_hDMA);
+  MAX7219_hSPI.pSPIx->CR2 &= ~(1 << SPI_CR2_TXDMAEN);
+  MAX7219_hSPI.TxState = SPI_STATE_READY;
+
+  //The interrupt may have ended the refresh meanwhile
+  if(MAX7219_TxBusy){
+      MAX7219_RowError(&MAX7219_hSPI);
+  }
+}
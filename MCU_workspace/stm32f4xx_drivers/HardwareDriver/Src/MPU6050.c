@@ -6,12 +6,61 @@
  */
 
 #include "MPU6050.h"
+#include "ParamStore.h"
+#include <stdlib.h>
 
 extern I2C_HandleTypeDef hi2c1;
 extern MPU6050_Data sensor_data;
 extern MPU6050_ConvertedData converted_data;
-double MPU_CalibValue = 0.0;
 uint16_t data_count = 0;
+static double MPU6050_CalibNoise;        // Largest standard deviation of the calibration samples (dps)
+static MPU6050_GyroCalib MPU6050_GyroCal;
+static MPU6050_AccelCalib MPU6050_AccelCal;
+static MPU6050_TempModel MPU6050_TempFit;
+
+/* Accelerometer correction fused with the range scale: a = raw * Gain[range][axis] - Bias[axis] */
+static float MPU6050_AccelFusedGain[4][3];
+static float MPU6050_AccelFusedBias[3];
+static uint32_t MPU6050_WakeTick;
+
+/* Active configuration and the conversion scales derived from it */
+static MPU6050_Config MPU6050_ActiveConfig;
+
+/* Conversion scale per full scale setting (datasheet sensitivity 131/65.5/32.8/16.4 LSB/dps
+ * and 16384/8192/4096/2048 LSB/g) */
+static const float MPU6050_GyroScale[4] = {1.0f / 131.0f, 1.0f / 65.5f, 1.0f / 32.8f, 1.0f / 16.4f};
+static const float MPU6050_AccelScale[4] = {9.81f / 16384.0f, 9.81f / 8192.0f, 9.81f / 4096.0f, 9.81f / 2048.0f};
+
+/* Auto-ranging state of one sensor */
+typedef struct {
+    uint8_t Reg;            // Config register holding the range
+    uint8_t Range;          // Range in use
+    uint8_t MinRange;       // Configured range, never narrowed below
+    uint8_t Settle;         // Samples left before the new range is trusted
+    uint16_t Calm;          // Consecutive samples below the down threshold
+} MPU6050_AutoRange_t;
+
+static MPU6050_AutoRange_t MPU6050_GyroAuto;
+static MPU6050_AutoRange_t MPU6050_AccelAuto;
+
+static void MPU6050_AutoRangeInit(MPU6050_AutoRange_t *pAuto, uint8_t Reg, uint8_t Range);
+static uint8_t MPU6050_AutoRangeTag(MPU6050_AutoRange_t *pAuto, uint8_t *pRange);
+static void MPU6050_AutoRangeUpdate(I2C_HandleTypeDef *hi2c, MPU6050_AutoRange_t *pAuto, int16_t x, int16_t y, int16_t z);
+static void MPU6050_ApplyAccelCalib(void);
+static uint16_t MPU6050_SampleStill(double Mean[3], double *pNoise, uint8_t Gyro);
+
+/* Filter group delay per DLPF setting, in us */
+static const uint16_t MPU6050_GyroDelayUs[7] = {980, 1900, 2800, 4800, 8300, 13400, 18600};
+static const uint16_t MPU6050_AccelDelayUs[7] = {0, 2000, 3000, 4900, 8500, 13800, 19000};
+
+/* Settings of MPU6050_Init() */
+static const MPU6050_Config MPU6050_DefaultConfig = {
+	.DLPF = MPU6050_DLPF_44HZ,
+	.SampleRateDiv = 0,
+	.GyroRange = MPU6050_GYRO_FS_250DPS,
+	.AccelRange = MPU6050_ACCEL_FS_2G,
+	.AutoRange = DISABLE,
+};
 
 /**
   * @brief  Write a register on MPU6050
@@ -38,13 +87,44 @@ static I2C_StatusTypeDef MPU6050_ReadRegister(I2C_HandleTypeDef *hi2c, uint8_t r
 }
 
 /**
-  * @brief  Initialize MPU6050 sensor
+  * @brief  Initialize MPU6050 sensor with the default settings (DLPF 44 Hz, 1 kHz,
+  *         +-250 dps, +-2 g).
   * @param  hi2c: Pointer to I2C_HandleTypeDef structure
   * @retval I2C_StatusTypeDef: Status of the operation
   */
 I2C_StatusTypeDef MPU6050_Init(I2C_HandleTypeDef *hi2c) {
+    return MPU6050_InitConfig(hi2c, &MPU6050_DefaultConfig);
+}
+
+/**
+  * @brief  Initialize MPU6050 sensor. The sensor is awake on return but still settling,
+  *         call MPU6050_WaitReady() before using its data. SysTick must be running.
+  * @param  hi2c: Pointer to I2C_HandleTypeDef structure
+  * @param  config: Filter, rate and ranges. Out of range fields fall back to the defaults.
+  * @retval I2C_StatusTypeDef: Status of the operation
+  */
+I2C_StatusTypeDef MPU6050_InitConfig(I2C_HandleTypeDef *hi2c, const MPU6050_Config *config) {
     I2C_StatusTypeDef status;
 
+    MPU6050_ActiveConfig = *config;
+    if (MPU6050_ActiveConfig.DLPF > MPU6050_DLPF_5HZ) {
+        MPU6050_ActiveConfig.DLPF = MPU6050_DefaultConfig.DLPF;
+    }
+    MPU6050_ActiveConfig.GyroRange &= 0x3;
+    MPU6050_ActiveConfig.AccelRange &= 0x3;
+
+    MPU6050_AutoRangeInit(&MPU6050_GyroAuto, MPU6050_REG_GYRO_CONFIG, MPU6050_ActiveConfig.GyroRange);
+    MPU6050_AutoRangeInit(&MPU6050_AccelAuto, MPU6050_REG_ACCEL_CONFIG, MPU6050_ActiveConfig.AccelRange);
+
+    // Stored accelerometer fit, identity until the six-position calibration has been run
+    if (ParamStore_Read(PARAMSTORE_ID_ACCEL_CALIB, &MPU6050_AccelCal, sizeof(MPU6050_AccelCal)) != PARAMSTORE_OK) {
+        for (uint8_t i = 0; i < 3; i++) {
+            MPU6050_AccelCal.Offset[i] = 0.0f;
+            MPU6050_AccelCal.Gain[i] = 1.0f;
+        }
+    }
+    MPU6050_ApplyAccelCalib();
+
    // check connect
     status = MPU6050_CheckDevice(hi2c);
     if (status != I2C_OK) {
@@ -56,21 +136,28 @@ I2C_StatusTypeDef MPU6050_Init(I2C_HandleTypeDef *hi2c) {
     if (status != I2C_OK) {
         return status;
     }
+    MPU6050_WakeTick = getTick();
 
     /* Digital filter configuration (DLPF)) */
-    status = MPU6050_WriteRegister(hi2c, MPU6050_REG_CONFIG, 0x03); // DLPF = 3 (44Hz)
+    status = MPU6050_WriteRegister(hi2c, MPU6050_REG_CONFIG, MPU6050_ActiveConfig.DLPF);
+    if (status != I2C_OK) {
+        return status;
+    }
+
+    /* Output data rate */
+    status = MPU6050_WriteRegister(hi2c, MPU6050_REG_SMPLRT_DIV, MPU6050_ActiveConfig.SampleRateDiv);
     if (status != I2C_OK) {
         return status;
     }
 
-    /* Gyroscope scale configuration  */
-    status = MPU6050_WriteRegister(hi2c, MPU6050_REG_GYRO_CONFIG, 0x00);
+    /* Gyroscope scale configuration (FS_SEL, bits 4:3) */
+    status = MPU6050_WriteRegister(hi2c, MPU6050_REG_GYRO_CONFIG, MPU6050_ActiveConfig.GyroRange << 3);
     if (status != I2C_OK) {
         return status;
     }
 
-    /* Accelerometer scale configuration */
-    status = MPU6050_WriteRegister(hi2c, MPU6050_REG_ACCEL_CONFIG, 0x00);
+    /* Accelerometer scale configuration (AFS_SEL, bits 4:3) */
+    status = MPU6050_WriteRegister(hi2c, MPU6050_REG_ACCEL_CONFIG, MPU6050_ActiveConfig.AccelRange << 3);
     if (status != I2C_OK) {
         return status;
     }
@@ -79,6 +166,56 @@ I2C_StatusTypeDef MPU6050_Init(I2C_HandleTypeDef *hi2c) {
     return I2C_OK;
 }
 
+/**
+  * @brief  Returns the configuration in use.
+  */
+const MPU6050_Config *MPU6050_GetConfig(void) {
+    return &MPU6050_ActiveConfig;
+}
+
+/**
+  * @brief  Returns the output data rate.
+  * @retval Sample rate in Hz
+  */
+uint32_t MPU6050_GetSampleRateHz(void) {
+    uint32_t gyroRate = (MPU6050_ActiveConfig.DLPF == MPU6050_DLPF_260HZ) ? 8000 : 1000;
+    return gyroRate / (1 + MPU6050_ActiveConfig.SampleRateDiv);
+}
+
+/**
+  * @brief  Returns the gyro filter group delay. The controller sees the rate this late,
+  *         plus up to one sample period of sampling delay.
+  * @retval Delay in us
+  */
+uint32_t MPU6050_GetGyroDelayUs(void) {
+    return MPU6050_GyroDelayUs[MPU6050_ActiveConfig.DLPF];
+}
+
+/**
+  * @brief  Returns the accelerometer filter group delay.
+  * @retval Delay in us
+  */
+uint32_t MPU6050_GetAccelDelayUs(void) {
+    return MPU6050_AccelDelayUs[MPU6050_ActiveConfig.DLPF];
+}
+
+/**
+  * @brief  Returns the gyro full scale in use, it differs from the configured one while
+  *         auto-ranging has widened it.
+  * @retval Value of @ref MPU6050_GYRO_FS_250DPS
+  */
+uint8_t MPU6050_GetGyroRange(void) {
+    return MPU6050_GyroAuto.Range;
+}
+
+/**
+  * @brief  Returns the accelerometer full scale in use.
+  * @retval Value of @ref MPU6050_ACCEL_FS_2G
+  */
+uint8_t MPU6050_GetAccelRange(void) {
+    return MPU6050_AccelAuto.Range;
+}
+
 /**
   * @brief  Check MPU6050 device connection
   * @param  hi2c: Pointer to I2C_HandleTypeDef structure
@@ -114,48 +251,274 @@ I2C_StatusTypeDef MPU6050_ReadData(I2C_HandleTypeDef *hi2c, MPU6050_Data *data)
     data->accel_y = (int16_t)((buffer[2] << 8) | buffer[3]);
     data->accel_z = (int16_t)((buffer[4] << 8) | buffer[5]);
 
+    // die temperature, between accel and gyro
+    data->temp = (int16_t)((buffer[6] << 8) | buffer[7]);
+
     // data of gyro
     data->gyro_x = (int16_t)((buffer[8] << 8) | buffer[9]);
     data->gyro_y = (int16_t)((buffer[10] << 8) | buffer[11]);
     data->gyro_z = (int16_t)((buffer[12] << 8) | buffer[13]);
 
+    // Range the sample was taken with, decided before this sample can change it
+    data->settling = 0;
+    if (MPU6050_AutoRangeTag(&MPU6050_GyroAuto, &data->gyro_range)) {
+        data->settling |= MPU6050_SETTLING_GYRO;
+    }
+    if (MPU6050_AutoRangeTag(&MPU6050_AccelAuto, &data->accel_range)) {
+        data->settling |= MPU6050_SETTLING_ACCEL;
+    }
+
+    if (MPU6050_ActiveConfig.AutoRange) {
+        MPU6050_AutoRangeUpdate(hi2c, &MPU6050_GyroAuto, data->gyro_x, data->gyro_y, data->gyro_z);
+        MPU6050_AutoRangeUpdate(hi2c, &MPU6050_AccelAuto, data->accel_x, data->accel_y, data->accel_z);
+    }
+
     return I2C_OK;
 }
 
 
 /**
-  * @brief  Calibrates the gyroscope bias on the X-axis of the MPU6050 sensor.
+  * @brief  Waits until MPU6050_STARTUP_MS have passed since the sensor was woken up.
+  *         Returns at once when the init that ran in between took longer.
+  * @param  None
+  * @retval None
+  */
+void MPU6050_WaitReady(void)
+{
+  while((uint32_t)(getTick() - MPU6050_WakeTick) < MPU6050_STARTUP_MS);
+}
+
+/**
+  * @brief  Calibrates the bias of the three gyroscope axes. One sample is taken per tick:
+  *         the output data rate is 1 kHz, faster reads would only average the same sample
+  *         again. A still calibration is stored; when the robot moved, the stored bias of
+  *         the last still boot is used instead.
   * @param  None
   * @retval None
   */
 void MPU6050_CalibGyro(void)
 {
-  for(uint16_t count = 0; count < 1000; count++){
-      if(MPU6050_ReadData(&hi2c1, &sensor_data) == I2C_OK){
-        MPU6050_ConvertData(&sensor_data, &converted_data);
-        MPU_CalibValue += converted_data.gyro_x_dps;
-        data_count ++;
+  double mean[3];
+  double temp;
+
+  data_count = MPU6050_SampleStill(mean, &MPU6050_CalibNoise, 1);
+  if(data_count == 0){
+      return;
+  }
+
+  // Die temperature of the last sample, it moves far slower than the calibration lasts
+  temp = sensor_data.temp * MPU6050_TEMP_SCALE + MPU6050_TEMP_OFFSET_C;
+
+  if(MPU6050_CalibNoise > MPU6050_CALIB_MAX_NOISE_DPS &&
+     ParamStore_Read(PARAMSTORE_ID_GYRO_CALIB, &MPU6050_GyroCal, sizeof(MPU6050_GyroCal)) == PARAMSTORE_OK){
+      return;
+  }
+
+  for(uint8_t i = 0; i < 3; i++){
+      MPU6050_GyroCal.Bias[i] = (float)mean[i];
+  }
+  MPU6050_GyroCal.TempC = (float)temp;
+
+  if(MPU6050_CalibNoise <= MPU6050_CALIB_MAX_NOISE_DPS){
+      //Append only: no erase on the boot path, a full store skips the save
+      ParamStore_Append(PARAMSTORE_ID_GYRO_CALIB, &MPU6050_GyroCal, sizeof(MPU6050_GyroCal));
+  }
+}
+
+/**
+  * @brief  Six-position accelerometer calibration, blocks until the robot has been laid
+  *         still on each of its six faces. Offset and gain per axis, no cross-axis terms.
+  *         The fit is stored and applied at once.
+  * @param  Progress: Called with the number of faces captured so far (0 to 6), may be NULL
+  * @retval 1 if the fit was accepted, 0 if it was out of range (previous fit kept)
+  */
+uint8_t MPU6050_CalibAccel(void (*Progress)(uint8_t Captured))
+{
+  double face[6][3];        // Mean reading per face, index 2 * vertical axis + (pointing down)
+  uint8_t captured = 0;
+  uint8_t count = 0;
+  MPU6050_AccelCalib fit;
+
+  if(Progress){
+      Progress(0);
+  }
+
+  while(count < 6){
+      double mean[3];
+      double noise;
+
+      if(MPU6050_SampleStill(mean, &noise, 0) < MPU6050_ACCEL_CALIB_SAMPLES / 2 ||
+         noise > MPU6050_ACCEL_CALIB_MAX_NOISE){
+          continue;
+      }
+
+      // Vertical axis, the robot must lie flat on a face
+      uint8_t axis = 0;
+      for(uint8_t i = 1; i < 3; i++){
+          if(fabs(mean[i]) > fabs(mean[axis])){
+              axis = i;
+          }
+      }
+      if(fabs(mean[axis]) < MPU6050_ACCEL_CALIB_MIN_AXIS * MPU6050_GRAVITY_MPS2){
+          continue;
+      }
+
+      uint8_t index = 2 * axis + (mean[axis] < 0.0);
+      if(captured & (1 << index)){
+          continue;
+      }
+
+      for(uint8_t i = 0; i < 3; i++){
+          face[index][i] = mean[i];
+      }
+      captured |= (1 << index);
+      count++;
+
+      if(Progress){
+          Progress(count);
       }
   }
 
-  MPU_CalibValue /= data_count;
+  // Per axis the true value is +g, -g and four times 0: the least-squares line has the
+  // mean of the six readings as offset and the up/down difference over 2 g as slope
+  for(uint8_t i = 0; i < 3; i++){
+      double sum = 0.0;
+      for(uint8_t f = 0; f < 6; f++){
+          sum += face[f][i];
+      }
+      double span = face[2 * i][i] - face[2 * i + 1][i];
+
+      fit.Offset[i] = (float)(sum / 6.0);
+      fit.Gain[i] = (float)(2.0 * MPU6050_GRAVITY_MPS2 / span);
+
+      if(fabsf(fit.Gain[i] - 1.0f) > MPU6050_ACCEL_CALIB_MAX_GAIN_ERR){
+          return 0;
+      }
+  }
+
+  MPU6050_AccelCal = fit;
+  MPU6050_ApplyAccelCalib();
+  ParamStore_Write(PARAMSTORE_ID_ACCEL_CALIB, &MPU6050_AccelCal, sizeof(MPU6050_AccelCal));
+
+  return 1;
+}
+
+/**
+  * @brief  Returns the gyro bias in use.
+  */
+const MPU6050_GyroCalib *MPU6050_GetGyroCalib(void)
+{
+  return &MPU6050_GyroCal;
+}
+
+/**
+  * @brief  Returns the accelerometer correction in use.
+  */
+const MPU6050_AccelCalib *MPU6050_GetAccelCalib(void)
+{
+  return &MPU6050_AccelCal;
+}
+
+/**
+  * @brief  Adds the last calibration to the bias vs temperature fit and stores the fit.
+  *         Call after MPU6050_CalibGyro(). The fit is appended, flash is never erased here.
+  *         The point is dropped when the robot moved during the calibration.
+  * @param  None
+  * @retval 1 if the point was learned
+  */
+uint8_t MPU6050_LearnTempModel(void)
+{
+  MPU6050_TempModel *fit = &MPU6050_TempFit;
+
+  if(ParamStore_Read(PARAMSTORE_ID_GYRO_TEMP, fit, sizeof(*fit)) != PARAMSTORE_OK || !(fit->Points >= 0.0f)){
+      memset(fit, 0, sizeof(*fit));
+  }
+
+  if(data_count == 0 || MPU6050_CalibNoise > MPU6050_CALIB_MAX_NOISE_DPS){
+      return 0;
+  }
+
+  // Fading memory: past the limit every point weighs a bit less than the new one
+  if(fit->Points >= MPU6050_TEMPCOMP_MAX_POINTS){
+      float fade = (MPU6050_TEMPCOMP_MAX_POINTS - 1.0f) / fit->Points;
+      fit->Points *= fade;
+      fit->SumT *= fade;
+      fit->SumB *= fade;
+      fit->SumTT *= fade;
+      fit->SumTB *= fade;
+  }
+
+  float t = MPU6050_GyroCal.TempC;
+  float b = MPU6050_GyroCal.Bias[0];
+  fit->Points += 1.0f;
+  fit->SumT += t;
+  fit->SumB += b;
+  fit->SumTT += t * t;
+  fit->SumTB += t * b;
+
+  // Least squares slope, only once the points cover enough temperatures
+  fit->Slope = 0.0f;
+  if(fit->Points >= MPU6050_TEMPCOMP_MIN_POINTS){
+      float meanT = fit->SumT / fit->Points;
+      float varT = fit->SumTT / fit->Points - meanT * meanT;
+      if(varT >= MPU6050_TEMPCOMP_MIN_SPREAD_C * MPU6050_TEMPCOMP_MIN_SPREAD_C){
+          float covTB = fit->SumTB / fit->Points - meanT * (fit->SumB / fit->Points);
+          float slope = covTB / varT;
+          if(fabsf(slope) <= MPU6050_TEMPCOMP_MAX_SLOPE){
+              fit->Slope = slope;
+          }
+      }
+  }
+
+  ParamStore_Append(PARAMSTORE_ID_GYRO_TEMP, fit, sizeof(*fit));
+  return 1;
+}
+
+/**
+  * @brief  Returns the bias vs temperature fit in use.
+  */
+const MPU6050_TempModel *MPU6050_GetTempModel(void)
+{
+  return &MPU6050_TempFit;
 }
 
 /**
-  * @brief  Convert raw data to physical units
+  * @brief  Gyro X bias at a die temperature, anchored on the boot calibration.
+  * @param  temp_c: Die temperature (degC)
+  * @retval Bias (dps)
+  */
+double MPU6050_GetGyroBias(double temp_c)
+{
+  return MPU6050_GyroCal.Bias[0] + MPU6050_TempFit.Slope * (temp_c - MPU6050_GyroCal.TempC);
+}
+
+/**
+  * @brief  Convert raw data to physical units, calibration applied: one multiply-add
+  *         per axis, the accelerometer gains are fused with the range scale.
   * @param  raw_data: Pointer to MPU6050_Data structure
   * @param  converted_data: Pointer to MPU6050_ConvertedData structure
   * @retval None
   */
 void MPU6050_ConvertData(const MPU6050_Data *raw_data, MPU6050_ConvertedData *converted_data) {
 
-    converted_data->accel_x_mps2 = (double)raw_data->accel_x * 9.81f / 16384.0f;
-    converted_data->accel_y_mps2 = (double)raw_data->accel_y * 9.81f / 16384.0f;
-    converted_data->accel_z_mps2 = (double)raw_data->accel_z * 9.81f / 16384.0f;
+    converted_data->temp_c = raw_data->temp * MPU6050_TEMP_SCALE + MPU6050_TEMP_OFFSET_C;
+
+    // Scale of the range each sample was taken with. A sample of unknown scale (range
+    // change in progress) is skipped and the previous value is held.
+    if (!(raw_data->settling & MPU6050_SETTLING_ACCEL)) {
+        const float *gain = MPU6050_AccelFusedGain[raw_data->accel_range & 0x3];
+        converted_data->accel_x_mps2 = raw_data->accel_x * gain[0] - MPU6050_AccelFusedBias[0];
+        converted_data->accel_y_mps2 = raw_data->accel_y * gain[1] - MPU6050_AccelFusedBias[1];
+        converted_data->accel_z_mps2 = raw_data->accel_z * gain[2] - MPU6050_AccelFusedBias[2];
+    }
 
-    converted_data->gyro_x_dps = (double)raw_data->gyro_x / 131.0f;
-    converted_data->gyro_y_dps = (double)raw_data->gyro_y / 131.0f;
-    converted_data->gyro_z_dps = (double)raw_data->gyro_z / 131.0f;
+    // Pitch axis bias follows the die temperature
+    if (!(raw_data->settling & MPU6050_SETTLING_GYRO)) {
+        float scale = MPU6050_GyroScale[raw_data->gyro_range & 0x3];
+        converted_data->gyro_x_dps = raw_data->gyro_x * scale - MPU6050_GetGyroBias(converted_data->temp_c);
+        converted_data->gyro_y_dps = raw_data->gyro_y * scale - MPU6050_GyroCal.Bias[1];
+        converted_data->gyro_z_dps = raw_data->gyro_z * scale - MPU6050_GyroCal.Bias[2];
+    }
 
 }
 
@@ -187,9 +550,148 @@ double MPU6050_GetAngle(const MPU6050_ConvertedData *data) {
     lastTick = currentTick;
 
     //Calculate Gyro pitch data use Complementary filter
-    double current_pitch_gyro = prev_pitch_gyro + (data->gyro_x_dps - MPU_CalibValue) * dt;
+    double current_pitch_gyro = prev_pitch_gyro + data->gyro_x_dps * dt;
     double angle = (1.0 - alpha) * current_pitch_gyro + alpha * pitch_acc;
     prev_pitch_gyro = angle;
 
     return angle;
 }
+
+
+/**
+  * @brief  Folds the accelerometer correction into the per-range scales:
+  *         Gain * (raw * scale - Offset) = raw * (scale * Gain) - Gain * Offset.
+  */
+static void MPU6050_ApplyAccelCalib(void) {
+    for (uint8_t i = 0; i < 3; i++) {
+        for (uint8_t range = 0; range < 4; range++) {
+            MPU6050_AccelFusedGain[range][i] = MPU6050_AccelScale[range] * MPU6050_AccelCal.Gain[i];
+        }
+        MPU6050_AccelFusedBias[i] = MPU6050_AccelCal.Gain[i] * MPU6050_AccelCal.Offset[i];
+    }
+}
+
+/**
+  * @brief  Averages uncorrected samples, one per tick, for the calibrations.
+  * @param  Mean: Mean of the X, Y, Z samples, in dps or m/s2
+  * @param  pNoise: Largest standard deviation of the three axes
+  * @param  Gyro: 1 for the gyroscope (MPU6050_CALIB_SAMPLES), 0 for the accelerometer
+  *         (MPU6050_ACCEL_CALIB_SAMPLES)
+  * @retval Number of samples averaged
+  */
+static uint16_t MPU6050_SampleStill(double Mean[3], double *pNoise, uint8_t Gyro) {
+    double sum[3] = {0.0, 0.0, 0.0};
+    double sumSq[3] = {0.0, 0.0, 0.0};
+    uint16_t samples = Gyro ? MPU6050_CALIB_SAMPLES : MPU6050_ACCEL_CALIB_SAMPLES;
+    uint16_t n = 0;
+
+    uint32_t tick = getTick();
+    for (uint16_t count = 0; count < samples; count++) {
+        while (getTick() == tick);
+        tick = getTick();
+
+        if (MPU6050_ReadData(&hi2c1, &sensor_data) != I2C_OK || sensor_data.settling) {
+            continue;
+        }
+
+        int16_t raw[3];
+        double scale;
+        if (Gyro) {
+            raw[0] = sensor_data.gyro_x;
+            raw[1] = sensor_data.gyro_y;
+            raw[2] = sensor_data.gyro_z;
+            scale = MPU6050_GyroScale[sensor_data.gyro_range];
+        } else {
+            raw[0] = sensor_data.accel_x;
+            raw[1] = sensor_data.accel_y;
+            raw[2] = sensor_data.accel_z;
+            scale = MPU6050_AccelScale[sensor_data.accel_range];
+        }
+
+        for (uint8_t i = 0; i < 3; i++) {
+            double v = raw[i] * scale;
+            sum[i] += v;
+            sumSq[i] += v * v;
+        }
+        n++;
+    }
+
+    *pNoise = 0.0;
+    for (uint8_t i = 0; i < 3; i++) {
+        Mean[i] = n ? sum[i] / n : 0.0;
+        double variance = n ? sumSq[i] / n - Mean[i] * Mean[i] : 0.0;
+        double noise = (variance > 0.0) ? sqrt(variance) : 0.0;
+        if (noise > *pNoise) {
+            *pNoise = noise;
+        }
+    }
+
+    return n;
+}
+
+/**
+  * @brief  Resets the auto-ranging state of one sensor to its configured range.
+  */
+static void MPU6050_AutoRangeInit(MPU6050_AutoRange_t *pAuto, uint8_t Reg, uint8_t Range) {
+    pAuto->Reg = Reg;
+    pAuto->Range = Range;
+    pAuto->MinRange = Range;
+    pAuto->Settle = 0;
+    pAuto->Calm = 0;
+}
+
+/**
+  * @brief  Gives the range of the sample just read.
+  * @param  pAuto: Sensor state
+  * @param  pRange: Range the sample was taken with
+  * @retval 1 if the sample was taken while a range change settles
+  */
+static uint8_t MPU6050_AutoRangeTag(MPU6050_AutoRange_t *pAuto, uint8_t *pRange) {
+    *pRange = pAuto->Range;
+
+    if (pAuto->Settle) {
+        pAuto->Settle--;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+  * @brief  Widens or narrows the range of one sensor from the peak of its last sample.
+  * @param  hi2c: Pointer to I2C_HandleTypeDef structure
+  * @param  pAuto: Sensor state
+  * @param  x, y, z: Raw sample
+  */
+static void MPU6050_AutoRangeUpdate(I2C_HandleTypeDef *hi2c, MPU6050_AutoRange_t *pAuto, int16_t x, int16_t y, int16_t z) {
+    if (pAuto->Settle) {
+        return;
+    }
+
+    int32_t peak = abs(x);
+    if (abs(y) > peak) peak = abs(y);
+    if (abs(z) > peak) peak = abs(z);
+
+    uint8_t range = pAuto->Range;
+    if (peak >= MPU6050_AUTORANGE_UP_LSB && range < 3) {
+        range++;
+    }
+    else if (peak < MPU6050_AUTORANGE_DOWN_LSB && range > pAuto->MinRange) {
+        if (++pAuto->Calm >= MPU6050_AUTORANGE_CALM_SAMPLES) {
+            range--;
+        }
+    }
+    else {
+        pAuto->Calm = 0;
+    }
+
+    if (range == pAuto->Range) {
+        return;
+    }
+
+    // Keep the old range if the write fails, the scale must match the sensor
+    if (MPU6050_WriteRegister(hi2c, pAuto->Reg, range << 3) == I2C_OK) {
+        pAuto->Range = range;
+        pAuto->Settle = MPU6050_AUTORANGE_SETTLE_SAMPLES;
+    }
+    pAuto->Calm = 0;
+}
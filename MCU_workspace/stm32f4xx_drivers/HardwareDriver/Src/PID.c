@@ -7,37 +7,188 @@
 
 #include "PID.h"
 
+static double PID_Step(PID_Controller *pid, double error, double rate, double dt);
+static double PID_Clamp(double value, double min, double max);
+static double PID_Elapsed(PID_Controller *pid);
+
 
 void PID_Init(PID_Controller* pid, double Kp, double Ki, double Kd) {
     pid->Kp = Kp;
     pid->Ki = Ki;
     pid->Kd = Kd;
 
-    pid->integral = 0.0f;
-    pid->prev_error = 0.0f;
+    pid->d_tau = 0.0f;
+    pid->out_min = -HUGE_VAL;
+    pid->out_max = HUGE_VAL;
+    pid->i_min = -HUGE_VAL;
+    pid->i_max = HUGE_VAL;
+
+    PID_Reset(pid);
+}
+
+/**
+  * @brief  Changes the gains on the fly. The I term is kept as it is, so the output
+  *         does not jump (bumpless).
+  * @param  pid: Controller
+  * @param  Kp, Ki, Kd: New gains
+  * @retval None
+  */
+void PID_SetTunings(PID_Controller *pid, double Kp, double Ki, double Kd)
+{
+	pid->Kp = Kp;
+	pid->Ki = Ki;
+	pid->Kd = Kd;
+}
+
+/**
+  * @brief  Sets the output range, e.g. the actuator limits.
+  * @param  pid: Controller
+  * @param  min, max: Output limits
+  * @retval None
+  */
+void PID_SetOutputLimits(PID_Controller *pid, double min, double max)
+{
+	if (min >= max) {
+		return;
+	}
+
+	pid->out_min = min;
+	pid->out_max = max;
+	pid->integral = PID_Clamp(pid->integral, min, max);
+}
+
+/**
+  * @brief  Sets the range of the I term.
+  * @param  pid: Controller
+  * @param  min, max: I term limits, in output units
+  * @retval None
+  */
+void PID_SetIntegralLimits(PID_Controller *pid, double min, double max)
+{
+	if (min >= max) {
+		return;
+	}
+
+	pid->i_min = min;
+	pid->i_max = max;
+	pid->integral = PID_Clamp(pid->integral, min, max);
+}
+
+/**
+  * @brief  Clears the controller state, gains and limits are kept. Use when the loop
+  *         is re-engaged, e.g. after the robot has been picked up.
+  * @param  pid: Controller
+  * @retval None
+  */
+void PID_Reset(PID_Controller *pid)
+{
+	pid->integral = 0.0f;
+	pid->prev_measured = 0.0f;
+	pid->d_term = 0.0f;
+	pid->last_us = 0;
+	pid->primed = 0;
+}
+
+/**
+  * @brief  Sets the low pass on the D term.
+  * @param  pid: Controller
+  * @param  tau: Time constant in s, 0 to disable
+  * @retval None
+  */
+void PID_SetDerivativeFilter(PID_Controller *pid, double tau)
+{
+	pid->d_tau = (tau > 0.0) ? tau : 0.0;
 }
 
+/**
+  * @brief  PID step, the rate of the measurement is obtained by differentiation.
+  *         dt comes from the microsecond time base, per controller.
+  * @param  pid: Controller
+  * @param  setpoint: Target
+  * @param  measured: Measurement
+  * @retval Command
+  */
 double PID_Compute(PID_Controller *pid, double setpoint, double measured)
 {
+	double dt = PID_Elapsed(pid);
 
-	static uint32_t lastTick = 0;
+	//No previous sample to differentiate against on the first call
+	double rate = 0.0;
+	if (dt > 0.0) {
+		rate = (measured - pid->prev_measured) / dt;
+	}
+	pid->prev_measured = measured;
 
+	return PID_Step(pid, setpoint - measured, rate, dt);
+}
 
-	double error = setpoint - measured;
-	 //Calculate dt
-	 uint32_t currentTick = getTick();
-	 double dt = (currentTick - lastTick) / 1000.0;
-	 lastTick = currentTick;
-	 if (dt < 0.001) dt = 0.01;
+/**
+  * @brief  PID step with a measured rate for the D term.
+  * @param  pid: Controller
+  * @param  setpoint: Target
+  * @param  measured: Measurement
+  * @param  rate: Time derivative of the measurement, same unit per second
+  * @param  dt: Time since the previous step in s, or PID_DT_MEASURED to take it from the
+  *         microsecond time base like PID_Compute() (the loop period may not be exact)
+  * @retval Command
+  */
+double PID_ComputeRate(PID_Controller *pid, double setpoint, double measured, double rate, double dt)
+{
+	if (dt <= 0.0) {
+		dt = PID_Elapsed(pid);
+	}
 
-	pid->integral += error * dt;
+	return PID_Step(pid, setpoint - measured, rate, dt);
+}
 
-	double derivative = (error - pid->prev_error) / dt;
 
-	double output = pid->Kp * error + pid->Ki * pid->integral + pid->Kd * derivative;
+/**
+  * @brief  Common part: filtered D on the measurement rate, integral with anti-windup,
+  *         clamped sum.
+  */
+static double PID_Step(PID_Controller *pid, double error, double rate, double dt)
+{
+	//d(error)/dt = -d(measured)/dt while the setpoint holds
+	double derivative = -pid->Kd * rate;
+	if (pid->d_tau > 0.0) {
+		pid->d_term += dt / (pid->d_tau + dt) * (derivative - pid->d_term);
+	}
+	else {
+		pid->d_term = derivative;
+	}
 
-	pid->prev_error = error;
+	double proportional = pid->Kp * error;
+	double output = proportional + pid->integral + pid->d_term;
 
-	return output;
+	//Integrate unless the output is already saturated in the direction of the step
+	double step = pid->Ki * error * dt;
+	if (!((output >= pid->out_max && step > 0.0) || (output <= pid->out_min && step < 0.0))) {
+		pid->integral = PID_Clamp(pid->integral + step, pid->i_min, pid->i_max);
+	}
+
+	output = proportional + pid->integral + pid->d_term;
+	return PID_Clamp(output, pid->out_min, pid->out_max);
 }
 
+/**
+  * @brief  Time since the previous call for this controller, 0 on the first call.
+  */
+static double PID_Elapsed(PID_Controller *pid)
+{
+	uint32_t now = getMicros();
+	double dt = pid->primed ? (uint32_t)(now - pid->last_us) * 1e-6 : 0.0;
+
+	pid->last_us = now;
+	pid->primed = 1;
+	return dt;
+}
+
+/**
+  * @brief  Limits a value to [min, max].
+  */
+static double PID_Clamp(double value, double min, double max)
+{
+	if (value > max) return max;
+	if (value < min) return min;
+	return value;
+}
@@ -0,0 +1,142 @@
+/*
+ * Ranging.c
+ *
+ *  Created on: Jul 11, 2025
+ *      Author: quanvm198
+ */
+
+#include "Ranging.h"
+#include "SR05.h"
+#include "EchoRanger.h"
+
+static const Ranging_Driver_t Ranging_Drivers[RANGING_SENSOR_COUNT] =
+{
+	[RANGING_SENSOR_FRONT] = { EchoRanger_Init, EchoRanger_Trigger, NULL,
+				   EchoRanger_GetDistance, EchoRanger_GetTimestamp, EchoRanger_GetStatus },
+	[RANGING_SENSOR_REAR]  = { SR05_Init, SR05_Trigger, SR05_Process,
+				   SR05_GetDistance, SR05_GetTimestamp, SR05_GetStatus },
+};
+
+static Ranging_Entry_t Ranging_Table[RANGING_SENSOR_COUNT];
+static uint8_t Ranging_Active;
+static uint32_t Ranging_SlotStart;
+
+static void Ranging_Collect(uint8_t Sensor);
+
+/**
+  * @brief  Initializes every sensor and fires the first one. Needs SysTick running.
+  * @retval None
+  */
+void Ranging_Init(void){
+  for(uint8_t i = 0; i < RANGING_SENSOR_COUNT; i++){
+      Ranging_Drivers[i].Init();
+      Ranging_Table[i].Distance = 0;
+      Ranging_Table[i].Timestamp = 0;
+      Ranging_Table[i].Status = RANGING_STATUS_NONE;
+      Ranging_Table[i].Valid = 0;
+  }
+
+  Ranging_Active = 0;
+  Ranging_SlotStart = getTick();
+  Ranging_Drivers[Ranging_Active].Trigger();
+}
+
+/**
+  * @brief  Runs the sensor drivers and moves to the next sensor when the slot is over.
+  *         Called every RANGING_SLOT_MS, returns immediately when there is nothing to do,
+  *         so the number of sensors does not add latency to the control loop.
+  * @retval None
+  */
+void Ranging_Process(void){
+  for(uint8_t i = 0; i < RANGING_SENSOR_COUNT; i++){
+      if(Ranging_Drivers[i].Process != NULL){
+	  Ranging_Drivers[i].Process();
+      }
+  }
+
+  //Results are taken as soon as they arrive, not only at the end of the slot
+  Ranging_Collect(Ranging_Active);
+
+  uint32_t now = getTick();
+  if((uint32_t)(now - Ranging_SlotStart) < RANGING_SLOT_MS){
+      return;
+  }
+
+  //No answer since the trigger of this slot
+  Ranging_Entry_t *pEntry = &Ranging_Table[Ranging_Active];
+  if(!pEntry->Valid || (int32_t)(pEntry->Timestamp - Ranging_SlotStart) < 0){
+      pEntry->Status = RANGING_STATUS_NO_RESPONSE;
+  }
+
+  //Slots stay on the grid of the calling task, a late call does not shorten the next slot
+  Ranging_Active = (Ranging_Active + 1) % RANGING_SENSOR_COUNT;
+  Ranging_SlotStart += RANGING_SLOT_MS;
+  if((uint32_t)(now - Ranging_SlotStart) >= RANGING_SLOT_MS){
+      Ranging_SlotStart = now;
+  }
+  Ranging_Drivers[Ranging_Active].Trigger();
+}
+
+/**
+  * @brief  Returns the table entry of a sensor.
+  * @param  Sensor: RANGING_SENSOR_xxx
+  */
+const Ranging_Entry_t *Ranging_GetEntry(uint8_t Sensor){
+  return &Ranging_Table[Sensor];
+}
+
+/**
+  * @brief  Returns the last valid distance of a sensor.
+  * @param  Sensor: RANGING_SENSOR_xxx
+  * @retval Distance in mm, 0 before the first valid measurement.
+  */
+uint16_t Ranging_GetDistance(uint8_t Sensor){
+  return Ranging_Table[Sensor].Distance;
+}
+
+/**
+  * @brief  Returns the time since the last answer of a sensor.
+  * @param  Sensor: RANGING_SENSOR_xxx
+  * @retval Age in ms, RANGING_AGE_NEVER if the sensor never answered.
+  */
+uint32_t Ranging_GetAge(uint8_t Sensor){
+  if(!Ranging_Table[Sensor].Valid){
+      return RANGING_AGE_NEVER;
+  }
+  return getTick() - Ranging_Table[Sensor].Timestamp;
+}
+
+/**
+  * @brief  Returns the status of a sensor.
+  * @param  Sensor: RANGING_SENSOR_xxx
+  * @retval Value of @ref RANGING_STATUS_NONE
+  */
+uint8_t Ranging_GetStatus(uint8_t Sensor){
+  return Ranging_Table[Sensor].Status;
+}
+
+
+/**
+  * @brief  Copies a new answer of the driver into the table.
+  * @param  Sensor: RANGING_SENSOR_xxx
+  */
+static void Ranging_Collect(uint8_t Sensor){
+  const Ranging_Driver_t *pDriver = &Ranging_Drivers[Sensor];
+  Ranging_Entry_t *pEntry = &Ranging_Table[Sensor];
+  uint8_t status = pDriver->GetStatus();
+  uint32_t timestamp = pDriver->GetTimestamp();
+
+  if(status == RANGING_STATUS_NONE || (pEntry->Valid && timestamp == pEntry->Timestamp)){
+      return;
+  }
+
+  //Only answers to the current trigger, a late frame from an older slot is ignored
+  if((int32_t)(timestamp - Ranging_SlotStart) < 0){
+      return;
+  }
+
+  pEntry->Distance = pDriver->GetDistance();
+  pEntry->Timestamp = timestamp;
+  pEntry->Status = status;
+  pEntry->Valid = 1;
+}
@@ -9,37 +9,267 @@
 #include "SR05.h"
 #include "stm32f407xx.h"
 
+static USART_HandleTypeDef SR05_hUSART;
+static DMA_HandleTypeDef SR05_hDMA;
+static uint8_t SR05_RxBuffer[SR05_RX_BUFFER_SIZE];
+
+//Written by the USART/DMA interrupts
+static __vo uint16_t SR05_WriteIndex;
+static __vo uint32_t SR05_RxTick;
+static __vo uint8_t SR05_RxSeq;
+
+//Owned by SR05_Process()
+static uint16_t SR05_ReadIndex;
+static SR05_Parser_t SR05_Parser;
+static uint8_t SR05_Status;
+static uint32_t SR05_Timestamp;
+
+static void SR05_RxEvent(USART_HandleTypeDef *husart, uint16_t Pos);
+
+/**
+  * @brief  Resets a parser to wait for a header and clears its statistics.
+  * @param  pParser: Parser state
+  * @retval None
+  */
+void SR05_Parser_Init(SR05_Parser_t *pParser){
+  pParser->State = SR05_STATE_HEADER;
+  pParser->High = 0;
+  pParser->Low = 0;
+  pParser->Hunting = 0;
+  pParser->Distance = 0;
+  pParser->Stats.ValidFrames = 0;
+  pParser->Stats.OutOfRange = 0;
+  pParser->Stats.ChecksumErrors = 0;
+  pParser->Stats.Resyncs = 0;
+}
+
 /**
-  * @brief  Reads distance data from SR05 ultrasonic sensor via USART.
-  * @param  pUSART: Pointer to the USART handle structure used for communication.
-  * @retval Distance value in centimeters if a valid frame is received;
-  *         returns 1 if a reserved invalid frame is detected (0xFF 0xAA 0xAA),
-  *         or previous distance value if checksum fails.
+  * @brief  Advances the parser by one received byte. Safe to call from an ISR.
+  *
+  * DATA_H never reaches 0xFF inside the measuring range, so a 0xFF where data is
+  * expected is taken as the header of a new frame and the partial frame is dropped.
+  *
+  * @param  pParser: Parser state
+  * @param  Byte: Received byte
+  * @retval SR05_PARSE_NONE until a frame completes, then its @ref SR05_PARSE_VALID result
   */
-uint16_t SR05_ReadData(USART_HandleTypeDef* pUSART) {
-    uint8_t pRxBuffer[4];
-    uint8_t byte = 0;
-    static uint16_t distance = 0;
+uint8_t SR05_Parser_PutByte(SR05_Parser_t *pParser, uint8_t Byte){
+  uint8_t result = SR05_PARSE_NONE;
 
-    // Wait for 0xFF header
-    for(uint16_t count = 0; count <= 5000; count++){
-        USART_Receive(pUSART, &byte, 1);
-        if (byte == 0xFF) {
-            pRxBuffer[0] = byte;
-            USART_Receive(pUSART, &pRxBuffer[1], 3);
-            break;
-        }
-    }
+  switch(pParser->State){
+    case SR05_STATE_HEADER:
+      if(Byte == SR05_FRAME_HEADER){
+	  pParser->Hunting = 0;
+	  pParser->State = SR05_STATE_DATA_H;
+      }
+      else if(!pParser->Hunting){
+	  //Count one resync per run of discarded bytes
+	  pParser->Hunting = 1;
+	  pParser->Stats.Resyncs++;
+      }
+      break;
 
-    if(pRxBuffer[1] == 0xAA && pRxBuffer[2] == 0xAA) return 1;
+    case SR05_STATE_DATA_H:
+      if(Byte == SR05_FRAME_HEADER){
+	  pParser->Stats.Resyncs++;
+	  break;
+      }
+      pParser->High = Byte;
+      pParser->State = SR05_STATE_DATA_L;
+      break;
 
-    uint8_t sum = (pRxBuffer[0] + pRxBuffer[1] + pRxBuffer[2]) & 0xFF;
+    case SR05_STATE_DATA_L:
+      pParser->Low = Byte;
+      pParser->State = SR05_STATE_SUM;
+      break;
 
-    if (sum == pRxBuffer[3]) {
-        distance = ((uint16_t)pRxBuffer[1] << 8) | pRxBuffer[2];
-    }
+    case SR05_STATE_SUM:
+      pParser->State = SR05_STATE_HEADER;
 
-    return distance;
+      if((uint8_t)(SR05_FRAME_HEADER + pParser->High + pParser->Low) != Byte){
+	  pParser->Stats.ChecksumErrors++;
+	  result = SR05_PARSE_CHECKSUM_ERROR;
+
+	  //The bad byte may be the header of the next frame
+	  if(Byte == SR05_FRAME_HEADER){
+	      pParser->State = SR05_STATE_DATA_H;
+	  }
+	  break;
+      }
+
+      uint16_t distance = ((uint16_t)pParser->High << 8) | pParser->Low;
+
+      if((pParser->High == SR05_FRAME_RESERVED && pParser->Low == SR05_FRAME_RESERVED) ||
+	 distance < SR05_DISTANCE_MIN || distance > SR05_DISTANCE_MAX){
+	  pParser->Stats.OutOfRange++;
+	  result = SR05_PARSE_OUT_OF_RANGE;
+      }
+      else{
+	  pParser->Distance = distance;
+	  pParser->Stats.ValidFrames++;
+	  result = SR05_PARSE_VALID;
+      }
+      break;
+
+    default:
+      pParser->State = SR05_STATE_HEADER;
+      break;
+  }
+
+  return result;
 }
 
+/**
+  * @brief  Feeds a block of bytes to the parser.
+  * @param  pParser: Parser state
+  * @param  pData: Received bytes
+  * @param  Len: Number of bytes
+  * @retval Result of the last frame that completed with a good checksum
+  *         (SR05_PARSE_VALID or SR05_PARSE_OUT_OF_RANGE), SR05_PARSE_NONE if none did.
+  */
+uint8_t SR05_Parser_Feed(SR05_Parser_t *pParser, const uint8_t *pData, uint16_t Len){
+  uint8_t last = SR05_PARSE_NONE;
+
+  for(uint16_t i = 0; i < Len; i++){
+      uint8_t result = SR05_Parser_PutByte(pParser, pData[i]);
+      if(result == SR05_PARSE_VALID || result == SR05_PARSE_OUT_OF_RANGE){
+	  last = result;
+      }
+  }
 
+  return last;
+}
+
+/**
+  * @brief  Starts the continuous reception of the sensor frames.
+  *         Bytes are moved by DMA into a ring buffer, the CPU only runs on IDLE line
+  *         and half/full buffer events to record the write position.
+  * @retval None
+  */
+void SR05_Init(void){
+  SR05_hDMA.Init.Direction = DMA_PERIPH_TO_MEMORY;
+  SR05_hDMA.Init.PeriphInc = DISABLE;
+  SR05_hDMA.Init.MemInc = ENABLE;
+  SR05_hDMA.Init.PeriphDataAlignment = DMA_DATA_BYTE;
+  SR05_hDMA.Init.MemDataAlignment = DMA_DATA_BYTE;
+  SR05_hDMA.Init.Mode = DMA_CIRCULAR;
+  SR05_hDMA.Init.Priority = DMA_PRIORITY_LOW;
+  SR05_hDMA.Init.FIFOMode = DISABLE;
+  SR05_hDMA.Init.DoubleBuffer = DISABLE;
+  DMA_Allocate(&SR05_hDMA, SR05_DMA_ALLOCATION);
+  DMA_Init(&SR05_hDMA);
+
+  SR05_hUSART.hdmarx = &SR05_hDMA;
+  SR05_hUSART.RxEventCallback = SR05_RxEvent;
+  USART_SetParam(&SR05_hUSART, SR05_USART, USART_MODE_TX_RX, USART_STOPBITS_1, USART_WORDLENGTH_8BITS, USART_PARITY_NONE, SR05_BAUDRATE);
+
+  SR05_WriteIndex = 0;
+  SR05_ReadIndex = 0;
+  SR05_Parser_Init(&SR05_Parser);
+  SR05_Status = SR05_PARSE_NONE;
+  SR05_Timestamp = 0;
+
+  USART_IRQPriorityConfig(SR05_IRQ, SR05_IRQ_PRIORITY);
+  USART_IRQInterruptConfig(SR05_IRQ, ENABLE);
+  USART_ReceiveToIdle_DMA(&SR05_hUSART, SR05_RxBuffer, SR05_RX_BUFFER_SIZE);
+}
+
+/**
+  * @brief  Requests one measurement (controlled output mode). The single byte goes
+  *         straight to the data register, nothing is sent if the transmitter is still busy.
+  * @retval None
+  */
+void SR05_Trigger(void){
+  if(USART_GetFlagStatus(SR05_USART, USART_FLAG_TXE)){
+      SR05_USART->DR = SR05_TRIGGER_BYTE;
+  }
+}
+
+/**
+  * @brief  Feeds the bytes received since the previous call to the parser and publishes
+  *         the result of the latest frame. Called from the main loop, never blocks.
+  * @retval None
+  */
+void SR05_Process(void){
+  uint8_t seq, result;
+  uint16_t writeIndex;
+  uint32_t rxTick;
+
+  //Consistent snapshot of the ISR fields
+  do{
+      seq = SR05_RxSeq;
+      writeIndex = SR05_WriteIndex;
+      rxTick = SR05_RxTick;
+  }while(seq != SR05_RxSeq);
+
+  if(writeIndex == SR05_ReadIndex){
+      return;
+  }
+
+  //The parser keeps partial frames, so the buffer is consumed up to the write index
+  if(writeIndex > SR05_ReadIndex){
+      result = SR05_Parser_Feed(&SR05_Parser, &SR05_RxBuffer[SR05_ReadIndex], writeIndex - SR05_ReadIndex);
+  }
+  else{
+      result = SR05_Parser_Feed(&SR05_Parser, &SR05_RxBuffer[SR05_ReadIndex], SR05_RX_BUFFER_SIZE - SR05_ReadIndex);
+      uint8_t wrapped = SR05_Parser_Feed(&SR05_Parser, SR05_RxBuffer, writeIndex);
+      if(wrapped != SR05_PARSE_NONE){
+	  result = wrapped;
+      }
+  }
+  SR05_ReadIndex = writeIndex;
+
+  if(result != SR05_PARSE_NONE){
+      SR05_Status = result;
+      SR05_Timestamp = rxTick;
+  }
+}
+
+/**
+  * @brief  Returns the last valid distance published by SR05_Process().
+  * @retval Distance in sensor units (mm), 0 before the first valid frame.
+  */
+uint16_t SR05_GetDistance(void){
+  return SR05_Parser.Distance;
+}
+
+/**
+  * @brief  Returns the time the last frame with a good checksum was received.
+  * @retval getTick() value in ms, 0 before the first frame.
+  */
+uint32_t SR05_GetTimestamp(void){
+  return SR05_Timestamp;
+}
+
+/**
+  * @brief  Returns the result of the last frame with a good checksum.
+  * @retval SR05_PARSE_VALID, SR05_PARSE_OUT_OF_RANGE (no echo or too close/far, the
+  *         distance keeps the previous value) or SR05_PARSE_NONE before the first frame.
+  */
+uint8_t SR05_GetStatus(void){
+  return SR05_Status;
+}
+
+/**
+  * @brief  Returns the frame statistics of the sensor link.
+  */
+const SR05_Stats_t *SR05_GetStats(void){
+  return &SR05_Parser.Stats;
+}
+
+
+/**
+  * @brief  Receive event (IDLE line, half or full buffer): records the write position only.
+  */
+static void SR05_RxEvent(USART_HandleTypeDef *husart, uint16_t Pos){
+  SR05_WriteIndex = Pos;
+  SR05_RxTick = getTick();
+  SR05_RxSeq++;
+}
+
+/**
+  * @brief  Sensor USART interrupt (IDLE line).
+  */
+void USART2_IRQHandler(void){
+  USART_IRQHandler(&SR05_hUSART);
+}
@@ -0,0 +1,112 @@
+/*
+ * Telemetry.c
+ *
+ *  Created on: Jul 13, 2025
+ *      Author: quanvm198
+ */
+
+#include "Telemetry.h"
+#include <string.h>
+
+static USART_HandleTypeDef Telemetry_hUSART;
+static DMA_HandleTypeDef Telemetry_hDMA;
+
+//Only written while the DMA is idle, the frame on the wire is never torn
+static uint8_t Telemetry_Frame[TELEMETRY_FRAME_MAX];
+static uint8_t Telemetry_Seq;
+static uint32_t Telemetry_Dropped;
+
+static uint8_t Telemetry_SendFrame(uint8_t Type, const void *pPayload, uint8_t Len);
+
+/**
+  * @brief  Configures USART1 TX and its DMA stream.
+  * @retval None
+  */
+void Telemetry_Init(void){
+  Telemetry_hDMA.Init.Direction = DMA_MEMORY_TO_PERIPH;
+  Telemetry_hDMA.Init.PeriphInc = DISABLE;
+  Telemetry_hDMA.Init.MemInc = ENABLE;
+  Telemetry_hDMA.Init.PeriphDataAlignment = DMA_DATA_BYTE;
+  Telemetry_hDMA.Init.MemDataAlignment = DMA_DATA_BYTE;
+  Telemetry_hDMA.Init.Mode = DMA_NORMAL;
+  Telemetry_hDMA.Init.Priority = DMA_PRIORITY_LOW;
+  Telemetry_hDMA.Init.FIFOMode = DISABLE;
+  Telemetry_hDMA.Init.DoubleBuffer = DISABLE;
+  DMA_Allocate(&Telemetry_hDMA, TELEMETRY_DMA_ALLOCATION);
+  DMA_Init(&Telemetry_hDMA);
+
+  Telemetry_hUSART.hdmatx = &Telemetry_hDMA;
+  USART_SetParam(&Telemetry_hUSART, TELEMETRY_USART, USART_MODE_TX, USART_STOPBITS_1, USART_WORDLENGTH_8BITS, USART_PARITY_NONE, TELEMETRY_BAUDRATE);
+
+  Telemetry_Seq = 0;
+  Telemetry_Dropped = 0;
+}
+
+/**
+  * @brief  Packs a sample into a frame and starts sending it.
+  * @param  pSample: Sample to send, copied before the call returns.
+  * @retval 1 if the frame was started, 0 if the previous one is still being sent
+  *         (the sample is dropped).
+  */
+uint8_t Telemetry_Send(const Telemetry_Sample_t *pSample){
+  return Telemetry_SendFrame(TELEMETRY_TYPE_SAMPLE, pSample, sizeof(Telemetry_Sample_t));
+}
+
+/**
+  * @brief  Sends the boot profile of the current boot.
+  * @retval 1 if the frame was started, 0 if the link is busy (try again later).
+  */
+uint8_t Telemetry_SendBoot(void){
+  const BootProfile_t *pProfile = BootProfile_Get();
+  Telemetry_Boot_t boot;
+
+  boot.BootCount = pProfile->BootCount;
+  boot.PrevLastPhase = pProfile->PrevLastPhase;
+  for(uint8_t i = 0; i < BOOT_PHASE_COUNT; i++){
+      boot.PhaseUs[i] = BootProfile_GetUs(i);
+  }
+
+  return Telemetry_SendFrame(TELEMETRY_TYPE_BOOT, &boot, sizeof(Telemetry_Boot_t));
+}
+
+/**
+  * @brief  Returns the number of samples dropped because the link was busy.
+  */
+uint32_t Telemetry_GetDropped(void){
+  return Telemetry_Dropped;
+}
+
+
+/**
+  * @brief  Builds a frame around a payload and starts the DMA transfer.
+  * @param  Type: TELEMETRY_TYPE_xxx
+  * @param  pPayload: Payload, copied into the frame buffer.
+  * @param  Len: Payload size, at most TELEMETRY_PAYLOAD_MAX.
+  * @retval 1 if the frame was started, 0 if the link is busy.
+  */
+static uint8_t Telemetry_SendFrame(uint8_t Type, const void *pPayload, uint8_t Len){
+  if(Telemetry_hUSART.TxState != USART_STATE_READY){
+      Telemetry_Dropped++;
+      return 0;
+  }
+
+  Telemetry_Frame[0] = TELEMETRY_SYNC0;
+  Telemetry_Frame[1] = TELEMETRY_SYNC1;
+  Telemetry_Frame[2] = Len;
+  Telemetry_Frame[3] = Type;
+  Telemetry_Frame[4] = Telemetry_Seq++;
+  memcpy(&Telemetry_Frame[TELEMETRY_HEADER_SIZE], pPayload, Len);
+
+  uint16_t size = TELEMETRY_HEADER_SIZE + Len;
+  uint8_t sum = 0;
+  for(uint16_t i = 2; i < size; i++){
+      sum += Telemetry_Frame[i];
+  }
+  Telemetry_Frame[size] = sum;
+
+  if(USART_Transmit_DMA(&Telemetry_hUSART, Telemetry_Frame, size + 1) != USART_STATE_READY){
+      Telemetry_Dropped++;
+      return 0;
+  }
+  return 1;
+}